@@ -0,0 +1,326 @@
+/**
+ *  \file BME280_Adaptive.cpp
+ *  \brief BOSCH BME280 Sensor Library. Adaptive Sampling.
+ *
+ *  \details Library C Code File
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include "BME280_I2C.h"
+
+#if BME280_USE_BUDGET
+#include "BME280_Adaptive.h"
+
+BME280_Adaptive::BME280_Adaptive(){
+	_profiles[BME280_PROFILE_STABLE]   = { 0b011, 0b001, 0b001, 0b010, 0b101 };
+	_profiles[BME280_PROFILE_MODERATE] = { 0b010, 0b001, 0b001, 0b001, 0b011 };
+	_profiles[BME280_PROFILE_DYNAMIC]  = { 0b001, 0b001, 0b001, 0b000, 0b001 };
+	activity_config();
+}
+
+/**
+ *  \brief Start Adaptive Sampling
+ *
+ *  \param [in] sensor Inited BME280 Sensor Node
+ *
+ *  \details Write the 'STABLE' Profile, or the first Profile inside the Budget, and start 'Normal Mode'
+ *  \details If no Profile fits the Budget, 'STABLE' is written
+ */
+void BME280_Adaptive::begin(BME280_I2C *sensor){
+	uint8_t p = fit(BME280_PROFILE_STABLE);
+	_sensor  = sensor;
+	_primed  = false;
+	_hold    = 0;
+	_pending = (p < BME280_ADAPTIVE_PROFILES) ? p : (uint8_t)BME280_PROFILE_STABLE;
+	apply(_pending);
+}
+
+/**
+ *  \brief Set Latency and Power Budget
+ *
+ *  \param [in] latency_us Maximum Time between two Samples in us, maximum Measurement Time plus StandBy Time. 0 = no Limit
+ *  \param [in] current_nA Maximum average Supply Current in nA. 0 = no Limit
+ *
+ *  \details Profiles outside the Budget are never written to the Sensor
+ *  \details If the active Profile is outside the new Budget, the nearest Profile inside is written at once
+ */
+void BME280_Adaptive::budget_config(uint32_t latency_us, uint32_t current_nA){
+	uint8_t p;
+	_latency_us = latency_us;
+	_current_nA = current_nA;
+	if (_sensor && !in_budget(_profile)){
+		p = fit(_profile);
+		if (p < BME280_ADAPTIVE_PROFILES){
+			_pending = p;
+			_hold    = 0;
+			apply(p);
+		}
+	}
+}
+
+/**
+ *  \brief Set Activity Thresholds
+ *
+ *  \param [in] P Pressure Threshold in raw ADC Units, 0 ... 32767
+ *  \param [in] T Temperature Threshold in raw ADC Units, 0 ... 32767
+ *  \param [in] H Humidity Threshold in raw ADC Units, 0 ... 32767
+ *
+ *  \details Activity is the Standard Deviation of each raw Channel over the last 'BME280_ADAPTIVE_TAU_MS'
+ *  \details At or above the Threshold selects 'DYNAMIC', at or above a Quarter of the Threshold selects 'MODERATE', else 'STABLE'
+ *  \details A Ramp of s Counts per Second shows about s * tau, independent of the Profile
+ *  \details Keep a Quarter of the Threshold above the Noise of the 'DYNAMIC' Profile. A Threshold of 0 ignores this Channel
+ */
+void BME280_Adaptive::activity_config(int32_t P, int32_t T, int32_t H){
+	P = (P < 0) ? 0 : (P > 32767) ? 32767 : P;
+	T = (T < 0) ? 0 : (T > 32767) ? 32767 : T;
+	H = (H < 0) ? 0 : (H > 32767) ? 32767 : H;
+	_thr_P = P * P;
+	_thr_T = T * T;
+	_thr_H = H * H;
+}
+
+/**
+ *  \brief Replace one Profile
+ *
+ *  \param [in] index BME280_PROFILE_STABLE, BME280_PROFILE_MODERATE or BME280_PROFILE_DYNAMIC
+ *  \param [in] profile Oversampling, Filter and StandBy Settings, see Tables in BME280_I2C.h
+ */
+void BME280_Adaptive::profile_config(uint8_t index, BME280_PROFILE profile){
+	if (index < BME280_ADAPTIVE_PROFILES){
+		_profiles[index] = profile;
+	}
+}
+
+/**
+ *  \brief Update Activity with the last Reading
+ *
+ *  \return True if the Sensor was reprogrammed
+ *
+ *  \details Call once after every 'read_adc_burst()' or 'read_adc_single()'
+ *  \details Tracks Mean and Variance of each raw Channel over 'BME280_ADAPTIVE_TAU_MS', then selects the Profile
+ *  \details The Sensor is only reprogrammed if the same Profile was requested 'BME280_ADAPTIVE_HOLD' times in a row
+ *  \details An active Profile outside the Budget, e.g. after 'profile_config()', is left at once
+ */
+bool BME280_Adaptive::update(void){
+	int32_t P = _sensor->raw_P();
+	int32_t T = _sensor->raw_T();
+	int32_t H = _sensor->raw_H();
+	uint8_t want;
+
+	if ( !_primed ){
+		_mean_P = P << 4;
+		_mean_T = T << 4;
+		_mean_H = H << 4;
+		_var_P  = 0;
+		_var_T  = 0;
+		_var_H  = 0;
+		_primed = true;
+		return false;
+	}
+
+	track(P, &_mean_P, &_var_P);
+	track(T, &_mean_T, &_var_T);
+	track(H, &_mean_H, &_var_H);
+
+	want = fit(wanted());
+	if (want >= BME280_ADAPTIVE_PROFILES){
+		return false;											// nothing fits, keep current Profile
+	}
+
+	if (want == _profile){
+		_hold = 0;
+		return false;
+	}
+	if (want != _pending){
+		_pending = want;
+		_hold = 0;
+	}
+	if (++_hold < BME280_ADAPTIVE_HOLD && in_budget(_profile)){
+		return false;
+	}
+	_hold = 0;
+	apply(want);
+	return true;
+}
+
+/**
+ *  \brief Active Profile
+ *
+ *  \return BME280_PROFILE_STABLE, BME280_PROFILE_MODERATE or BME280_PROFILE_DYNAMIC
+ */
+uint8_t BME280_Adaptive::profile(void){
+	return _profile;
+}
+
+/**
+ *  \brief Effective Sample Rate of the active Profile
+ *
+ *  \return Output Data Rate in mHz. Output value of "1984" equals 1.984 Hz
+ *
+ *  \details 1 / ( typical Measurement Time + StandBy Time )
+ */
+uint32_t BME280_Adaptive::rate_mHz(void){
+	return 1000000000UL / profile_period_us(_profile);
+}
+
+/**
+ *  \brief Typical Measurement Time of the active Profile
+ *
+ *  \return Measurement Time in us
+ */
+uint32_t BME280_Adaptive::measure_time_us(void){
+	BME280_PROFILE *p = &_profiles[_profile];
+	return BME280_I2C::measure_time_us(p->osrs_p, p->osrs_t, p->osrs_h);
+}
+
+/**
+ *  \brief Average Supply Current of the active Profile
+ *
+ *  \return Current in nA
+ */
+uint32_t BME280_Adaptive::current_nA(void){
+	return profile_current_nA(_profile);
+}
+
+/**
+ *  \brief Profile requested by the current Activity
+ *
+ *  \return Most responsive Profile requested by any Channel
+ *
+ *  \details Variance against the squared Thresholds, a Quarter of the Threshold is a Sixteenth of its Square
+ */
+uint8_t BME280_Adaptive::wanted(void){
+	if ( (_thr_P && _var_P >= _thr_P) ||
+		 (_thr_T && _var_T >= _thr_T) ||
+		 (_thr_H && _var_H >= _thr_H) ){
+		return BME280_PROFILE_DYNAMIC;
+	}
+	if ( (_thr_P && _var_P >= (_thr_P >> 4)) ||
+		 (_thr_T && _var_T >= (_thr_T >> 4)) ||
+		 (_thr_H && _var_H >= (_thr_H >> 4)) ){
+		return BME280_PROFILE_MODERATE;
+	}
+	return BME280_PROFILE_STABLE;
+}
+
+/**
+ *  \brief Nearest Profile inside the Budget
+ *
+ *  \param [in] want requested Profile
+ *  \return 'want' if it fits, else the next less responsive, else the next more responsive Profile
+ *  \return BME280_ADAPTIVE_PROFILES if no Profile fits
+ */
+uint8_t BME280_Adaptive::fit(uint8_t want){
+	int8_t i;
+	if (in_budget(want)){
+		return want;
+	}
+	for (i = want - 1 ; i >= 0 && !in_budget(i) ; i--);			// less responsive first
+	if (i < 0){
+		for (i = want + 1 ; i < BME280_ADAPTIVE_PROFILES && !in_budget(i) ; i++);
+	}
+	return (i < 0) ? BME280_ADAPTIVE_PROFILES : (uint8_t)i;
+}
+
+/**
+ *  \brief Check Profile against Latency and Power Budget
+ *
+ *  \param [in] index Profile to check
+ *  \return True if the Profile fits both Budgets
+ */
+bool BME280_Adaptive::in_budget(uint8_t index){
+	BME280_PROFILE *p = &_profiles[index];
+
+	if (_latency_us && BME280_I2C::measure_time_us(p->osrs_p, p->osrs_t, p->osrs_h, true) + BME280_I2C::standby_time_us(p->t_sb) > _latency_us){
+		return false;
+	}
+	if (_current_nA && profile_current_nA(index) > _current_nA){
+		return false;
+	}
+	return true;
+}
+
+/**
+ *  \brief Average Supply Current of a Profile
+ *
+ *  \param [in] index Profile to calculate
+ *  \return Current in nA
+ *
+ *  \details Same Model as 'BME280_I2C::budget()' in 'Normal Mode', see 'BME280_I2C::average_current_nA()'
+ */
+uint32_t BME280_Adaptive::profile_current_nA(uint8_t index){
+	BME280_PROFILE *p = &_profiles[index];
+	return BME280_I2C::average_current_nA(p->osrs_p, p->osrs_t, p->osrs_h, profile_period_us(index), true);
+}
+
+/**
+ *  \brief Time between two Samples of a Profile
+ *
+ *  \param [in] index Profile to calculate
+ *  \return typical Measurement Time plus StandBy Time in us
+ */
+uint32_t BME280_Adaptive::profile_period_us(uint8_t index){
+	BME280_PROFILE *p = &_profiles[index];
+	return BME280_I2C::measure_time_us(p->osrs_p, p->osrs_t, p->osrs_h) + BME280_I2C::standby_time_us(p->t_sb);
+}
+
+/**
+ *  \brief Exponentially weighted Mean and Variance of one raw Channel
+ *
+ *  \param [in] x raw ADC Value
+ *  \param [in,out] mean Mean in Q4
+ *  \param [in,out] var Variance in raw Counts squared
+ *
+ *  \details d = x - mean, mean += alpha * d, var = ( 1 - alpha ) * ( var + alpha * d^2 )
+ *  \details alpha is the Period of the active Profile over 'BME280_ADAPTIVE_TAU_MS', so the Window is the same Time
+ *  \details at every Sample Rate: a Ramp of s Counts per Second gives var = ( 1 - alpha ) * ( s * tau )^2
+ *  \details d is limited to 32767 Counts, so var stays below 2^30
+ */
+void BME280_Adaptive::track(int32_t x, int32_t *mean, int32_t *var){
+	int32_t d = (x << 4) - *mean;
+	int32_t c = d >> 4;
+	int32_t v;
+
+	if (c > 32767){
+		c = 32767;
+	} else if (c < -32767){
+		c = -32767;
+	}
+	*mean += mul_alpha(d);
+	v      = *var + mul_alpha(c * c);
+	*var   = v - mul_alpha(v);
+}
+
+/**
+ *  \brief Weight a Value by alpha
+ *
+ *  \return ( a * alpha ) >> 16 without a 64 Bit Product
+ */
+int32_t BME280_Adaptive::mul_alpha(int32_t a){
+	return (a >> 16) * (int32_t)_alpha + (int32_t)((((uint32_t)a & 0xFFFF) * _alpha) >> 16);
+}
+
+/**
+ *  \brief Write Profile to BME280
+ *
+ *  \param [in] index Profile to write
+ *
+ *  \details 'BME280_REGISTER_CONFIG' is only accepted in 'Sleep Mode', so go to Sleep, write and restart 'Normal Mode'
+ *  \details alpha = Period / 'BME280_ADAPTIVE_TAU_MS' in Q16 follows the new Period
+ */
+void BME280_Adaptive::apply(uint8_t index){
+	BME280_PROFILE *p = &_profiles[index];
+	uint32_t a = (profile_period_us(index) * 1024UL / 125 * 8) / BME280_ADAPTIVE_TAU_MS;
+
+	_sensor->osrs_config(p->osrs_p, p->osrs_t, p->osrs_h);
+	_sensor->filter_config(p->t_sb, p->filter);
+	_sensor->sleep();
+	_sensor->filter_write();
+	_sensor->normal();
+	_profile = index;
+	_alpha   = (a > 65535) ? 65535 : (uint16_t)a;
+}
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ *  \file BME280_Adaptive.h
+ *  \brief BOSCH BME280 Sensor Library. Adaptive Sampling.
+ *
+ *  \details Library Definition File
+ *  \details Switches Oversampling, Filter and StandBy Time in 'Normal Mode' by Signal Activity
+ *  \details Needs the Library built with 'BME280_USE_BUDGET=1'
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_ADAPTIVE_H__
+#define __BME280_ADAPTIVE_H__
+
+#include "BME280_I2C.h"
+
+#if !BME280_USE_BUDGET
+#error "BME280_Adaptive needs the Timing Helpers, build the Library with -DBME280_USE_BUDGET=1"
+#endif
+
+/***********************************************************************
+ *  BME280 ADAPTIVE Settings
+ *  BME280_ADAPTIVE_HOLD    Samples a new Profile has to be requested in a row before the Sensor is reprogrammed
+ *  BME280_ADAPTIVE_TAU_MS  Time Constant of the Activity Variance in ms, the same for every Profile
+ **********************************************************************/
+#define BME280_ADAPTIVE_PROFILES		3
+#define BME280_ADAPTIVE_HOLD			8
+#ifndef BME280_ADAPTIVE_TAU_MS
+#define BME280_ADAPTIVE_TAU_MS			8000
+#endif
+
+/***********************************************************************
+ *  BME280 ADAPTIVE Profiles. See Table.
+ ***********************************************************************
+	profile	|	osrs_p	osrs_t	osrs_h	filter	t_sb
+	--------+--------------------------------------------
+	 0		|	x4		x1		x1		x4		1000 ms		STABLE
+	 1		|	x2		x1		x1		x2		250 ms		MODERATE
+	 2		|	x1		x1		x1		OFF		62.5 ms		DYNAMIC
+ **********************************************************************/
+enum{
+	BME280_PROFILE_STABLE				= 0,
+	BME280_PROFILE_MODERATE				= 1,
+	BME280_PROFILE_DYNAMIC				= 2,
+};
+
+typedef struct{
+	uint8_t  osrs_p;
+	uint8_t  osrs_t;
+	uint8_t  osrs_h;
+	uint8_t  filter;
+	uint8_t  t_sb;
+} BME280_PROFILE;
+
+/***********************************************************************
+ *  BME280_ADAPTIVE CLASS
+ **********************************************************************/
+class BME280_Adaptive{
+	public:
+
+		BME280_Adaptive(void);
+
+		void	 begin( BME280_I2C *sensor );
+
+		void	 budget_config(		uint32_t latency_us = 0,
+									uint32_t current_nA = 0	);
+		void	 activity_config(	int32_t  P = 256,
+									int32_t  T = 256,
+									int32_t  H = 64	);
+		void	 profile_config( uint8_t index, BME280_PROFILE profile );
+
+		bool	 update(void);
+
+		uint8_t	 profile(void);
+		uint32_t rate_mHz(void);
+		uint32_t measure_time_us(void);
+		uint32_t current_nA(void);
+
+	private:
+		uint8_t	 wanted(void);
+		uint8_t	 fit( uint8_t want );
+		bool	 in_budget( uint8_t index );
+		uint32_t profile_current_nA( uint8_t index );
+		uint32_t profile_period_us( uint8_t index );
+		void	 track( int32_t x, int32_t *mean, int32_t *var );
+		int32_t	 mul_alpha( int32_t a );
+		void	 apply( uint8_t index );
+
+		BME280_I2C		*_sensor	= NULL;
+
+		BME280_PROFILE	 _profiles[BME280_ADAPTIVE_PROFILES];
+
+		uint32_t _latency_us		= 0;
+		uint32_t _current_nA		= 0;
+
+		int32_t  _thr_P				= 0;		// Threshold squared
+		int32_t  _thr_T				= 0;
+		int32_t  _thr_H				= 0;
+
+		int32_t  _mean_P			= 0;		// Q4 fixed point
+		int32_t  _mean_T			= 0;
+		int32_t  _mean_H			= 0;
+		int32_t  _var_P				= 0;		// raw Counts squared
+		int32_t  _var_T				= 0;
+		int32_t  _var_H				= 0;
+		uint16_t _alpha				= 0;		// Weight of one Sample, Q16
+
+		uint8_t  _profile			= BME280_PROFILE_STABLE;
+		uint8_t  _pending			= BME280_PROFILE_STABLE;
+		uint8_t  _hold				= 0;
+		bool	 _primed			= false;
+};
+
+#endif
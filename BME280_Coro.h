@@ -0,0 +1,489 @@
+/**
+ *  \file BME280_Coro.h
+ *  \brief BOSCH BME280 Sensor Library. C++20 Coroutine Measurement.
+ *
+ *  \details Library Definition File, Header only
+ *  \details 'co_await node.measure()' triggers 'Forced Mode', suspends for the maximum Measurement Time and returns the compensated Sample
+ *  \details Coroutine Frames come from a static Pool, the Heap is only used when the Pool is exhausted or a Frame is too large
+ *  \details One Thread drives many Sensors: while one Sensor converts, the Loop resumes the others
+ *  \details Needs C++20 ('-std=c++20'), the File is empty for older Standards
+ *  \details Needs the Library built with 'BME280_USE_BUDGET=1'
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_CORO_H__
+#define __BME280_CORO_H__
+
+#include "BME280_I2C.h"
+
+#if __cplusplus >= 202002L
+
+#if !BME280_USE_BUDGET
+#error "BME280_Coro needs the Timing Helpers, build the Library with -DBME280_USE_BUDGET=1"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <new>
+#include <cstddef>
+
+#if BME280_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************************
+ *  BME280 CORO Settings
+ *  BME280_CORO_TIMERS       Maximum Number of suspended Coroutines in one 'BME280_Loop', more block the Thread while they sleep
+ *  BME280_CORO_FRAMES       Coroutine Frames in the static Pool, every running 'BME280_Task' holds one:
+ *                           one per 'measure()' in Flight plus one per own Task awaiting it
+ *  BME280_CORO_FRAME_BYTES  Size of one Pool Frame. 'measure()' needs 136 Bytes with g++ on x86-64, less on 32 Bit
+ **********************************************************************/
+#ifndef BME280_CORO_TIMERS
+#define BME280_CORO_TIMERS				64
+#endif
+#ifndef BME280_CORO_FRAMES
+#define BME280_CORO_FRAMES				8
+#endif
+#ifndef BME280_CORO_FRAME_BYTES
+#define BME280_CORO_FRAME_BYTES			192
+#endif
+
+/***********************************************************************
+ *  BME280_FRAMEPOOL CLASS
+ *  Fixed Pool of 'BME280_CORO_FRAMES' Frames for the Coroutines of 'BME280_Task'.
+ *  Freed Frames go to a Free List, unused Frames are handed out in Order, so
+ *  the Pool needs no Initialisation and works for Tasks of static Objects.
+ *  A larger Frame or an exhausted Pool falls back to the Heap, 'heap_frames()'
+ *  counts these Allocations. One Thread only, like the Coroutines.
+ **********************************************************************/
+class BME280_FramePool{
+	public:
+		static void	*alloc( size_t n ){
+			BME280_FRAME *f = NULL;
+			if (n <= sizeof(BME280_FRAME)){
+				if (_free){
+					f     = _free;
+					_free = f->next;
+				} else if (_used < BME280_CORO_FRAMES){
+					f = &_frames[_used++];
+				}
+			}
+			if ( !f ){
+				_heap++;
+				return ::operator new(n);
+			}
+			return f;
+		}
+
+		static void	 release( void *p ){
+			uintptr_t a = (uintptr_t)p;
+			if (a >= (uintptr_t)&_frames[0] && a < (uintptr_t)&_frames[BME280_CORO_FRAMES]){
+				BME280_FRAME *f = (BME280_FRAME *)p;
+				f->next = _free;
+				_free   = f;
+			} else {
+				::operator delete(p);
+			}
+		}
+
+		/**
+		 *  \brief Number of Frames taken from the Heap so far
+		 */
+		static uint32_t heap_frames(void){
+			return _heap;
+		}
+
+	private:
+		union BME280_FRAME{
+			BME280_FRAME *next;
+			alignas(std::max_align_t) unsigned char bytes[BME280_CORO_FRAME_BYTES];
+		};
+
+		inline static BME280_FRAME	 _frames[BME280_CORO_FRAMES];
+		inline static BME280_FRAME	*_free	= NULL;
+		inline static uint16_t		 _used	= 0;
+		inline static uint32_t		 _heap	= 0;
+};
+
+/***********************************************************************
+ *  BME280_TASK CLASS
+ *  Lazy Coroutine returning T. 'co_await' starts it and resumes the Caller when it returns.
+ *  A Task that is not awaited is started with 'start()', 'done()' tells when it is finished.
+ **********************************************************************/
+template<typename T>
+struct BME280_TaskResult{
+	T		 value				= T();
+	void	 return_value( T v ){ value = v; }
+	T		 result(void){ return value; }
+};
+
+template<>
+struct BME280_TaskResult<void>{
+	void	 return_void(void){}
+	void	 result(void){}
+};
+
+template<typename T = void>
+class BME280_Task{
+	public:
+
+		struct promise_type : BME280_TaskResult<T>{
+			std::coroutine_handle<> cont;
+
+			static void *operator new( size_t n ){ return BME280_FramePool::alloc(n); }
+			static void  operator delete( void *p ){ BME280_FramePool::release(p); }
+
+			BME280_Task get_return_object(void){
+				return BME280_Task(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			std::suspend_always initial_suspend(void) noexcept { return {}; }
+
+			struct final_awaiter{
+				bool	 await_ready(void) noexcept { return false; }
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+					std::coroutine_handle<> c = h.promise().cont;
+					return c ? c : std::noop_coroutine();
+				}
+				void	 await_resume(void) noexcept {}
+			};
+			final_awaiter final_suspend(void) noexcept { return {}; }
+			void	 unhandled_exception(void){ std::terminate(); }
+		};
+
+		BME280_Task(void){}
+		BME280_Task( BME280_Task &&o ) noexcept : _h(o._h){ o._h = nullptr; }
+		BME280_Task &operator=( BME280_Task &&o ) noexcept {
+			if (this != &o){
+				if (_h){
+					_h.destroy();
+				}
+				_h = o._h;
+				o._h = nullptr;
+			}
+			return *this;
+		}
+		BME280_Task( const BME280_Task & ) = delete;
+		~BME280_Task(void){
+			if (_h){
+				_h.destroy();
+			}
+		}
+
+		/**
+		 *  \brief Start a Task that is not awaited by another Coroutine
+		 */
+		void	 start(void){
+			if (_h && !_h.done()){
+				_h.resume();
+			}
+		}
+
+		/**
+		 *  \brief Task finished
+		 */
+		bool	 done(void){
+			return !_h || _h.done();
+		}
+
+		/**
+		 *  \brief Return Value of a finished Task
+		 */
+		T		 result(void){
+			return _h.promise().result();
+		}
+
+		bool	 await_ready(void) noexcept { return false; }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+			_h.promise().cont = caller;
+			return _h;
+		}
+		T		 await_resume(void){
+			return _h.promise().result();
+		}
+
+	private:
+		explicit BME280_Task( std::coroutine_handle<promise_type> h ) : _h(h){}
+
+		std::coroutine_handle<promise_type> _h = nullptr;
+};
+
+/***********************************************************************
+ *  BME280_EXECUTOR CLASS
+ *  Timer Interface between the Coroutines and an Event Loop. Implement
+ *  'now_us()' and 'at()' to run the Coroutines on any other Loop.
+ **********************************************************************/
+class BME280_Executor{
+	public:
+
+		virtual ~BME280_Executor(void){}
+
+		/**
+		 *  \brief Current Time in us, may wrap around
+		 */
+		virtual uint32_t now_us(void) = 0;
+
+		/**
+		 *  \brief Resume 'h' at 'due_us' or later
+		 *
+		 *  \return False if the Timer could not be queued
+		 */
+		virtual bool	 at( uint32_t due_us, std::coroutine_handle<> h ) = 0;
+
+		/**
+		 *  \brief Block the Thread until 'due_us'
+		 *
+		 *  \details Fallback if 'at()' could not queue the Timer, so a Sleep never ends early. Spins on 'now_us()' by Default
+		 */
+		virtual void	 block_until( uint32_t due_us ){
+			while ((int32_t)(now_us() - due_us) < 0);
+		}
+
+		struct sleep_awaiter{
+			BME280_Executor *ex;
+			uint32_t us;
+
+			bool	 await_ready(void) noexcept { return us == 0; }
+			bool	 await_suspend(std::coroutine_handle<> h){
+				uint32_t due = ex->now_us() + us;
+				if (ex->at(due, h)){
+					return true;
+				}
+				ex->block_until(due);						// no free Timer: wait here, then continue without Suspension
+				return false;
+			}
+			void	 await_resume(void) noexcept {}
+		};
+
+		/**
+		 *  \brief Suspend the calling Coroutine for 'us' Microseconds
+		 *
+		 *  \details Usage: co_await loop.sleep_for(1000);
+		 */
+		sleep_awaiter sleep_for( uint32_t us ){
+			return sleep_awaiter{ this, us };
+		}
+};
+
+/***********************************************************************
+ *  BME280_LOOP CLASS
+ *  Single Thread Timer Loop. Binary Heap of at most 'BME280_CORO_TIMERS'
+ *  Timers in the Object, the Loop itself never allocates. Override 'idle()' to sleep in an RTOS or poll
+ *  other Event Sources while waiting. With more suspended Coroutines than
+ *  Timers, the Sleep blocks the Thread instead: still correct, no longer
+ *  concurrent.
+ **********************************************************************/
+class BME280_Loop : public BME280_Executor{
+	public:
+
+		/**
+		 *  \brief Clock of the Platform: micros() on Arduino, CLOCK_MONOTONIC on Linux
+		 */
+		uint32_t now_us(void) override {
+#if BME280_LINUX
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+#else
+			return micros();
+#endif
+		}
+
+		bool	 at( uint32_t due_us, std::coroutine_handle<> h ) override {
+			uint16_t i;
+			if (_n >= BME280_CORO_TIMERS){
+				return false;
+			}
+			i = _n++;
+			while (i && before(due_us, _heap[(i - 1) / 2].due)){
+				_heap[i] = _heap[(i - 1) / 2];
+				i = (i - 1) / 2;
+			}
+			_heap[i].due = due_us;
+			_heap[i].h   = h;
+			return true;
+		}
+
+		/**
+		 *  \brief Resume every due Coroutine, never blocks
+		 *
+		 *  \return Number of resumed Coroutines
+		 *
+		 *  \details For a foreign Event Loop: call 'poll()', then wait up to 'next_us()'
+		 */
+		uint16_t poll(void){
+			uint16_t n = 0;
+			while (_n && !before(now_us(), _heap[0].due)){
+				std::coroutine_handle<> h = pop();
+				h.resume();
+				n++;
+			}
+			return n;
+		}
+
+		/**
+		 *  \brief Time until the next Timer is due
+		 *
+		 *  \return us, 0 if a Timer is due, 0xFFFFFFFF if no Timer is queued
+		 */
+		uint32_t next_us(void){
+			int32_t d;
+			if ( !_n ){
+				return 0xFFFFFFFF;
+			}
+			d = (int32_t)(_heap[0].due - now_us());
+			return d > 0 ? (uint32_t)d : 0;
+		}
+
+		/**
+		 *  \brief Run until no Timer is left
+		 */
+		void	 run(void){
+			while (_n){
+				uint32_t wait = next_us();
+				if (wait){
+					idle(wait);
+				}
+				poll();
+			}
+		}
+
+		/**
+		 *  \brief Number of queued Timers
+		 */
+		uint16_t pending(void){
+			return _n;
+		}
+
+		/**
+		 *  \brief Wait with 'idle()' until 'due_us', used when the Timer Heap is full
+		 */
+		void	 block_until( uint32_t due_us ) override {
+			int32_t d;
+			while ((d = (int32_t)(due_us - now_us())) > 0){
+				idle((uint32_t)d);
+			}
+		}
+
+	protected:
+		/**
+		 *  \brief Wait for the next Timer
+		 *
+		 *  \param [in] us Time until the next Timer is due
+		 */
+		virtual void idle( uint32_t us ){
+#if BME280_LINUX
+			struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000L };
+			nanosleep(&ts, NULL);
+#else
+			delayMicroseconds(us);
+#endif
+		}
+
+	private:
+		typedef struct{
+			uint32_t due;
+			std::coroutine_handle<> h;
+		} BME280_TIMER;
+
+		/**
+		 *  \brief Wrap-around safe 'a < b'
+		 */
+		static bool before( uint32_t a, uint32_t b ){
+			return (int32_t)(a - b) < 0;
+		}
+
+		std::coroutine_handle<> pop(void){
+			std::coroutine_handle<> h = _heap[0].h;
+			BME280_TIMER last = _heap[--_n];
+			uint16_t i = 0;
+			for (;;){
+				uint16_t c = 2 * i + 1;
+				if (c >= _n){
+					break;
+				}
+				if (c + 1 < _n && before(_heap[c + 1].due, _heap[c].due)){
+					c++;
+				}
+				if ( !before(_heap[c].due, last.due) ){
+					break;
+				}
+				_heap[i] = _heap[c];
+				i = c;
+			}
+			_heap[i] = last;
+			return h;
+		}
+
+		BME280_TIMER _heap[BME280_CORO_TIMERS];
+		uint16_t _n					= 0;
+};
+
+/***********************************************************************
+ *  BME280 READING
+ *  Result of 'BME280_Coro::measure()'. 'ok' is false if a Bus Transfer failed,
+ *  'sample' is all Zero then, never the Values of an earlier Measurement.
+ **********************************************************************/
+typedef struct{
+	bool		  ok;
+	BME280_SAMPLE sample;
+} BME280_READING;
+
+/***********************************************************************
+ *  BME280_CORO CLASS
+ *  Awaitable Measurement of one Sensor on one Executor. All Coroutines of
+ *  one Loop run on one Thread, so I2C Transfers of Sensors on a shared
+ *  Bus never interleave.
+ **********************************************************************/
+class BME280_Coro{
+	public:
+
+		/**
+		 *  \brief Bind Sensor and Executor
+		 *
+		 *  \param [in] sensor Inited BME280 Sensor Node
+		 *  \param [in] ex Timer Loop, e.g. 'BME280_Loop'
+		 */
+		BME280_Coro( BME280_I2C *sensor, BME280_Executor *ex ) : _sensor(sensor), _ex(ex){}
+
+		/**
+		 *  \brief One Measurement in 'Forced Mode'
+		 *
+		 *  \return Awaitable, yields 'BME280_READING': 'ok' and the compensated Sample
+		 *
+		 *  \details forced(), suspend for the maximum Measurement Time of the active Oversampling, read_adc_burst(), sample()
+		 *  \details If 'read_adc_burst()' fails, 'ok' is false and the Sample is not compensated
+		 *  \details Every Call is one Coroutine Frame from 'BME280_FramePool'
+		 *  \details Usage: BME280_READING r = co_await node.measure(); if (r.ok) { ... r.sample ... }
+		 */
+		BME280_Task<BME280_READING> measure(void){
+			BME280_BUDGET  b;
+			BME280_READING r = {};
+			_sensor->forced();
+			_sensor->budget(&b);
+			co_await _ex->sleep_for(b.meas_max_us);
+			r.ok = _sensor->read_adc_burst();
+			if (r.ok){
+				_sensor->sample(&r.sample);
+			}
+			co_return r;
+		}
+
+		/**
+		 *  \brief Suspend until the next Sample Period
+		 *
+		 *  \param [in] us Time to sleep
+		 */
+		BME280_Executor::sleep_awaiter sleep_for( uint32_t us ){
+			return _ex->sleep_for(us);
+		}
+
+	private:
+		BME280_I2C		*_sensor	= NULL;
+		BME280_Executor	*_ex		= NULL;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,341 @@
+/**
+ *  \file BME280_Derived.cpp
+ *  \brief BOSCH BME280 Sensor Library. Derived Quantities.
+ *
+ *  \details Library C Code File
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include "BME280_Derived.h"
+
+BME280_Derived::BME280_Derived(){}
+
+/**
+ *  \brief Set Station Altitude for Sea-Level Pressure
+ *
+ *  \param [in] altitude Altitude of the Sensor above sea level in m
+ *
+ *  \details Inverse of 'altitude_dbl()' in BME280_I2C: P0 = P / ( 1 - h / 44330 ) ^ ( 1 / 0.1903 )
+ *  \details The Factor only depends on the Altitude, so pow() is called here once and not per Sample
+ */
+void BME280_Derived::altitude_config(float altitude){
+	_altitude = altitude;
+	_slp_factor = (float) pow(1.0 - (double)altitude / 44330.0, -1.0 / 0.1903);
+	_slp_q29    = (uint32_t)(_slp_factor * 536870912.0f + 0.5f);
+}
+
+/**
+ *  \brief Compute all derived Quantities from one compensated Sample
+ *
+ *  \param [in] T Temperature in DegC, resolution is 0.01 DegC. Output of 'temperature()'
+ *  \param [in] P Pressure in Pa. Output of 'pressure()' or 'pressure_i64()'
+ *  \param [in] H Humidity in %RH in Q22.10 format. Output of 'humidity()'
+ *  \param [out] data Derived Quantities
+ *
+ *  \details Single Pass: the Magnus exponent and the vapour pressure are computed once and shared
+ *  \details by Dew Point and Absolute Humidity. Per Sample three float Divisions (Magnus exponent, Dew Point,
+ *  \details Absolute Humidity), one fast_exp() and one fast_ln(), the Heat Index adds sqrtf() below 13 %RH.
+ *  \details fast_exp() has a relative Error below 1.5e-4, fast_ln() an absolute Error below 6.2e-5.
+ *  \details Against 'compute_dbl()' this gives: Dew Point < 0.01 DegC, Absolute Humidity < 0.02 %,
+ *  \details Heat Index and Sea-Level Pressure are exact to float Resolution.
+ */
+void BME280_Derived::compute(int32_t T, uint32_t P, uint32_t H, BME280_DERIVED_DATA *data){
+	float t, rh, x, gamma;
+
+	t  = (float)T * 0.01f;
+	rh = (float)H * (1.0f / 1024.0f);
+	if (rh < 0.01f){
+		rh = 0.01f;					// Dew Point is undefined for 0 %RH
+	}
+
+	x = BME280_MAGNUS_B * t / (BME280_MAGNUS_A + t);
+	data->vapour_pressure = BME280_MAGNUS_C * fast_exp(x) * rh * 0.01f;
+	gamma = x + fast_ln(rh * 0.01f);
+
+	data->dew_point    = BME280_MAGNUS_A * gamma / (BME280_MAGNUS_B - gamma);
+	data->abs_humidity = 216.7f * data->vapour_pressure / (t + 273.15f);
+	data->heat_index   = heat_index(t, rh);
+	data->sea_level    = (float)P * _slp_factor;
+}
+
+/**
+ *  \brief Compute all derived Quantities in Fixed Point
+ *
+ *  \param [in] T Temperature in DegC, resolution is 0.01 DegC. Output of 'temperature()'
+ *  \param [in] P Pressure in Pa. Output of 'pressure()' or 'pressure_i64()'
+ *  \param [in] H Humidity in %RH in Q22.10 format. Output of 'humidity()'
+ *  \param [out] data Derived Quantities
+ *
+ *  \details For Boards without FPU: no float, no libm and no 64 Bit Arithmetic, every Product fits into 32 Bit.
+ *  \details Same single Pass as 'compute()': gamma = x + ln(RH) is shared by Dew Point and vapour pressure,
+ *  \details e = C * exp(gamma) is shared by vapour pressure and Absolute Humidity.
+ *  \details Per Sample six 32 Bit Divisions, fix_ln() and fix_es() use the Polynomials of fast_ln() and fast_exp().
+ *  \details Against 'compute_dbl()' from -40 to 85 DegC: Dew Point < 0.01 DegC, vapour pressure and Absolute Humidity
+ *  \details < 2.5e-4 relative plus 1 LSB, Heat Index < 0.04 DegC up to 50 DegC (0.07 DegC to 85 DegC), Sea-Level Pressure < 1 Pa.
+ *  \details Humidity below 10 (0.01 %RH in Q22.10) is taken as 10.
+ */
+void BME280_Derived::compute_i32(int32_t T, uint32_t P, uint32_t H, BME280_DERIVED_I32 *data){
+	int32_t  x, gamma;
+	uint32_t es, tk;
+
+	if (H < 10){
+		H = 10;						// Dew Point is undefined for 0 %RH
+	}
+
+	/*
+	 * x = B * t / ( A + t ) = B - A * B / ( A + t ), gamma = x + ln(RH / 100), both Q16
+	 */
+	x     = BME280_MAGNUS_B_Q16 - (int32_t)fix_div(BME280_MAGNUS_AB_Q12, (uint32_t)(24312 + T), 4);
+	gamma = x + fix_ln(H) - BME280_LN_RH_Q16;
+
+	/*
+	 * Dew Point = A * gamma / ( B - gamma ) = A * B / ( B - gamma ) - A, rounded to 0.01 DegC
+	 */
+	data->dew_point = (int32_t)((fix_div(BME280_MAGNUS_AB_Q12, (uint32_t)(BME280_MAGNUS_B_Q16 - gamma), 5) + 1) >> 1) - 24312;
+
+	/*
+	 * e = C * exp(gamma) in Pa Q8, Absolute Humidity = 216.7 * e / T in 0.01 g/m^3
+	 */
+	es = fix_es(gamma);
+	tk = (uint32_t)(T + 27315);
+	data->vapour_pressure = (es + 128) >> 8;
+	data->abs_humidity    = ((es / tk) * 21670UL + (es % tk) * 21670UL / tk + 128) >> 8;
+
+	data->heat_index = fix_heat_index(T, H);
+
+	/*
+	 * P * Factor with 17 Bit P, split at Bit 16 to stay within 32 Bit, Q2 then rounded
+	 */
+	data->sea_level = (((uint32_t)fix_mul((int32_t)_slp_q29, (uint16_t)(P & 0xFFFF)) >> 11) + (P >> 16) * ((_slp_q29 + 1024) >> 11) + 2) >> 2;
+}
+
+/**
+ *  \brief Compute all derived Quantities with 'Double Precision'
+ *
+ *  \param [in] T Temperature in DegC. Output of 'temperature_dbl()'
+ *  \param [in] P Pressure in Pa. Output of 'pressure_dbl()'
+ *  \param [in] H Humidity in %rH. Output of 'humidity_dbl()'
+ *  \param [out] data Derived Quantities
+ *
+ *  \details Reference Implementation with libm exp(), log() and pow() on every Sample
+ */
+void BME280_Derived::compute_dbl(double T, double P, double H, BME280_DERIVED_DATA *data){
+	double es, gamma;
+
+	if (H < 0.01){
+		H = 0.01;
+	}
+
+	es = BME280_MAGNUS_C * exp(BME280_MAGNUS_B * T / (BME280_MAGNUS_A + T));
+	gamma = log(H / 100.0) + BME280_MAGNUS_B * T / (BME280_MAGNUS_A + T);
+
+	data->vapour_pressure = (float)(es * H / 100.0);
+	data->dew_point       = (float)(BME280_MAGNUS_A * gamma / (BME280_MAGNUS_B - gamma));
+	data->abs_humidity    = (float)(216.7 * es * H / 100.0 / (T + 273.15));
+	data->heat_index      = heat_index((float)T, (float)H);
+	data->sea_level       = (float)(P / pow(1.0 - (double)_altitude / 44330.0, 1.0 / 0.1903));
+}
+
+/**
+ *  \brief Heat Index
+ *
+ *  \param [in] T Temperature in DegC
+ *  \param [in] RH Humidity in %rH
+ *  \return Heat Index in DegC
+ *
+ *  \details Formula was taken from NOAA NWS (Rothfusz Regression with Adjustments), calculated in DegF
+ *  \details Polynomial only, the Regression itself is accurate to +-1.3 DegF, so float is sufficient
+ */
+float BME280_Derived::heat_index(float T, float RH){
+	float F, HI;
+
+	F  = T * 1.8f + 32.0f;
+	HI = 0.5f * (F + 61.0f + (F - 68.0f) * 1.2f + RH * 0.094f);
+
+	if ((HI + F) * 0.5f >= 80.0f){
+		HI = -42.379f + F * (2.04901523f + F * (-0.00683783f))
+		   + RH * (10.14333127f + F * (-0.22475541f + F * 0.00122874f))
+		   + RH * RH * (-0.05481717f + F * (0.00085282f + F * (-0.00000199f)));
+		if (RH < 13.0f && F >= 80.0f && F <= 112.0f){
+			HI -= ((13.0f - RH) * 0.25f) * sqrtf((17.0f - fabsf(F - 95.0f)) / 17.0f);
+		} else if (RH > 85.0f && F >= 80.0f && F <= 87.0f){
+			HI += ((RH - 85.0f) * 0.1f) * ((87.0f - F) * 0.2f);
+		}
+	}
+
+	return (HI - 32.0f) * (1.0f / 1.8f);
+}
+
+/**
+ *  \brief Fast natural Logarithm
+ *
+ *  \param [in] x Positive Argument
+ *  \return ln(x), absolute Error below 6.2e-5
+ *
+ *  \details Split x into Exponent and Mantissa [1,2), then a 4th order Polynomial for ln(Mantissa)
+ */
+float BME280_Derived::fast_ln(float x){
+	uint32_t bits;
+	float    e, m;
+
+	memcpy(&bits, &x, sizeof(bits));
+	e = (float)((int32_t)((bits >> 23) & 0xFF) - 127);
+	bits = (bits & 0x007FFFFF) | 0x3F800000;
+	memcpy(&m, &bits, sizeof(m));
+
+	return e * 0.69314718f + (-1.7417939f + (2.8212026f + (-1.4699568f + (0.44717955f - 0.056570851f * m) * m) * m) * m);
+}
+
+/**
+ *  \brief Fast Exponential
+ *
+ *  \param [in] x Argument, expected in the Range of the Magnus Exponent (-10 ... 10)
+ *  \return exp(x), relative Error below 1.5e-4
+ *
+ *  \details exp(x) = 2^(x * log2(e)). Integer Part goes into the Exponent Bits, a 3rd order Polynomial for the Fraction
+ */
+float BME280_Derived::fast_exp(float x){
+	uint32_t bits;
+	float    fl, f, p;
+
+	x  = x * 1.44269504f;
+	fl = floorf(x);
+	f  = x - fl;
+	p  = 1.0f + f * (0.6960656f + f * (0.2244667f + f * 0.0794135f));
+
+	memcpy(&bits, &p, sizeof(bits));
+	bits += (uint32_t)((int32_t)fl) << 23;
+	memcpy(&p, &bits, sizeof(p));
+
+	return p;
+}
+
+/**
+ *  \brief Fixed Point Heat Index
+ *
+ *  \param [in] T Temperature in 0.01 DegC
+ *  \param [in] H Humidity in %RH in Q22.10 format
+ *  \return Heat Index in 0.01 DegC
+ *
+ *  \details Same NWS Formula as 'heat_index()', calculated in DegF Q16 with F / 256 and RH / 128 as Q16 Fractions,
+ *  \details so every Horner Step is one fix_mul(). Coefficients are the Rothfusz Coefficients * 256^i * 128^j in Q16.
+ */
+int32_t BME280_Derived::fix_heat_index(int32_t T, uint32_t H){
+	int32_t  u, f, r, a, b, c, d;
+	uint32_t v;
+
+	u = T * 576 / 125 + 8192;		// DegF in Q8
+	f = u * 256;					// DegF in Q16
+	v = H >> 1;						// RH / 128 in Q16
+	r = -675021L + f + fix_mul(f, 6554) + fix_mul(394265L, (uint16_t)v);
+
+	if (r + f >= 10485760L){
+		a = -2777350L  + fix_mul(  34376771L + fix_mul( -29368256L, (uint16_t)u), (uint16_t)u);
+		b = 85088430L  + fix_mul(-482658568L + fix_mul( 675506959L, (uint16_t)u), (uint16_t)u);
+		c = -58859488L + fix_mul( 234421377L + fix_mul(-140033801L, (uint16_t)u), (uint16_t)u);
+		r = a + fix_mul(b + fix_mul(c, (uint16_t)v), (uint16_t)v);
+		if (H < 13 * 1024UL && u >= 80 * 256L && u <= 112 * 256L){
+			d  = 17 * 256L - (u > 95 * 256L ? u - 95 * 256L : 95 * 256L - u);
+			r -= (int32_t)(((13 * 1024UL - H) * fix_sqrt((((uint32_t)d << 18) / 17) << 4)) >> 11);
+		} else if (H > 85 * 1024UL && u >= 80 * 256L && u <= 87 * 256L){
+			r += (int32_t)((H - 85 * 1024UL) * (uint32_t)(87 * 256L - u) / 200);
+		}
+	}
+
+	return (fix_mul(r - 2097152L, 56889) + 512) >> 10;
+}
+
+/**
+ *  \brief Fixed Point natural Logarithm
+ *
+ *  \param [in] x Argument, at least 1
+ *  \return ln(x) in Q16, absolute Error below 1e-4
+ *
+ *  \details Split x into Exponent and Mantissa [1,2), then ln(m) = 2 * atanh(z) with z = (m - 1) / (m + 1) below 1/3
+ */
+int32_t BME280_Derived::fix_ln(uint32_t x){
+	uint32_t m, z, z2, p;
+	uint8_t  k = 0;
+
+	while (x >> (k + 1)){
+		k++;
+	}
+	m  = (k <= 15) ? x << (15 - k) : x >> (k - 15);
+	z  = ((m - 32768UL) << 16) / (m + 32768UL);
+	z2 = (z * z) >> 16;
+	p  = (z2 * 7282UL) >> 16;
+	p  = (z2 * (9362UL + p)) >> 16;
+	p  = (z2 * (13107UL + p)) >> 16;
+	p  = (z2 * (21845UL + p)) >> 16;
+
+	return (int32_t)((z * (65536UL + p)) >> 15) + k * BME280_LN2_Q16;
+}
+
+/**
+ *  \brief Fixed Point saturation vapour pressure
+ *
+ *  \param [in] x Magnus Exponent in Q16
+ *  \return C * exp(x) in Pa Q8
+ *
+ *  \details exp(x) = 2^(x * log2(e)), same 3rd order Polynomial for the Fraction as fast_exp()
+ */
+uint32_t BME280_Derived::fix_es(int32_t x){
+	int32_t  y, s;
+	uint32_t f, p;
+
+	y = (x >> 16) * (BME280_LOG2E_Q15 * 2) + (int32_t)(((uint32_t)(x & 0xFFFF) * BME280_LOG2E_Q15) >> 15);
+	f = (uint32_t)y & 0xFFFF;
+	p = (f * 5204UL) >> 16;
+	p = (f * (14711UL + p)) >> 16;
+	p = (f * (45617UL + p)) >> 16;
+	p = ((65536UL + p) >> 1) * BME280_MAGNUS_C_Q6;
+
+	s = 13 - (y >> 16);
+	if (s >= 32){
+		return 0;
+	}
+	return (s >= 0) ? p >> s : p << -s;
+}
+
+/**
+ *  \brief Fixed Point Multiplication
+ *
+ *  \return ( a * b ) >> 16 without a 64 Bit Product
+ */
+int32_t BME280_Derived::fix_mul(int32_t a, uint16_t b){
+	return (a >> 16) * (int32_t)b + (int32_t)((((uint32_t)a & 0xFFFF) * b) >> 16);
+}
+
+/**
+ *  \brief Fixed Point Division
+ *
+ *  \return ( n << s ) / d without a 64 Bit Dividend, d must be below 2^(32 - s)
+ */
+uint32_t BME280_Derived::fix_div(uint32_t n, uint32_t d, uint8_t s){
+	return ((n / d) << s) + ((n % d) << s) / d;
+}
+
+/**
+ *  \brief Integer Square Root
+ *
+ *  \return floor(sqrt(x))
+ */
+uint16_t BME280_Derived::fix_sqrt(uint32_t x){
+	uint32_t r = 0, bit = 1UL << 30;
+
+	while (bit > x){
+		bit >>= 2;
+	}
+	while (bit){
+		if (x >= r + bit){
+			x -= r + bit;
+			r  = (r >> 1) + bit;
+		} else {
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint16_t)r;
+}
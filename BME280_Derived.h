@@ -0,0 +1,87 @@
+/**
+ *  \file BME280_Derived.h
+ *  \brief BOSCH BME280 Sensor Library. Derived Quantities.
+ *
+ *  \details Library Definition File
+ *  \details Dew Point, Absolute Humidity, Heat Index and Sea-Level Pressure from one compensated Sample
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_DERIVED_H__
+#define __BME280_DERIVED_H__
+
+#include "BME280_I2C.h"
+
+/***********************************************************************
+ *  BME280 MAGNUS Constants
+ *  Saturation vapour pressure over water, valid from -45 to 60 DegC.
+ *  es(T) = C * exp( B * T / ( A + T ) )
+ **********************************************************************/
+#define BME280_MAGNUS_A					243.12f
+#define BME280_MAGNUS_B					17.62f
+#define BME280_MAGNUS_C					6.112f
+
+/***********************************************************************
+ *  BME280 MAGNUS Constants, Fixed Point for 'compute_i32()'
+ *  Q16 = Value * 2^16, all Products stay within 32 Bit
+ **********************************************************************/
+#define BME280_MAGNUS_B_Q16				1154744L		// B
+#define BME280_MAGNUS_AB_Q12			1754633994L		// A * B * 100, 'A' in 0.01 DegC
+#define BME280_MAGNUS_C_Q6				39117L			// C * 100, 'C' in Pa
+#define BME280_LN2_Q16					45426L			// ln(2)
+#define BME280_LN_RH_Q16				756065L			// ln(100 * 1024), Humidity Q22.10 to Fraction
+#define BME280_LOG2E_Q15				47274L			// log2(e)
+
+/***********************************************************************
+ *  BME280 DERIVED DATA
+ **********************************************************************/
+typedef struct{
+	float vapour_pressure;		// Actual vapour pressure in hPa
+	float dew_point;			// Dew point in DegC
+	float abs_humidity;			// Absolute humidity in g/m^3
+	float heat_index;			// Heat index in DegC
+	float sea_level;			// Pressure reduced to sea level in Pa
+} BME280_DERIVED_DATA;
+
+typedef struct{
+	uint32_t vapour_pressure;	// Actual vapour pressure in Pa
+	int32_t  dew_point;			// Dew point in 0.01 DegC
+	uint32_t abs_humidity;		// Absolute humidity in 0.01 g/m^3
+	int32_t  heat_index;		// Heat index in 0.01 DegC
+	uint32_t sea_level;			// Pressure reduced to sea level in Pa
+} BME280_DERIVED_I32;
+
+/***********************************************************************
+ *  BME280_DERIVED CLASS
+ **********************************************************************/
+class BME280_Derived{
+	public:
+
+		BME280_Derived(void);
+
+		void	 altitude_config( float altitude = 0.0f );
+
+		void	 compute(	 int32_t T, uint32_t P, uint32_t H, BME280_DERIVED_DATA *data );
+		void	 compute_i32( int32_t T, uint32_t P, uint32_t H, BME280_DERIVED_I32 *data );
+		void	 compute_dbl( double T, double P, double H, BME280_DERIVED_DATA *data );
+
+	private:
+		float	 fast_ln(float x);
+		float	 fast_exp(float x);
+		float	 heat_index(float T, float RH);
+
+		int32_t	 fix_ln(uint32_t x);
+		uint32_t fix_es(int32_t x);
+		int32_t	 fix_heat_index(int32_t T, uint32_t H);
+		int32_t	 fix_mul(int32_t a, uint16_t b);
+		uint32_t fix_div(uint32_t n, uint32_t d, uint8_t s);
+		uint16_t fix_sqrt(uint32_t x);
+
+		float	 _altitude			= 0.0f;
+		float	 _slp_factor		= 1.0f;
+		uint32_t _slp_q29			= 1UL << 29;
+};
+
+#endif
@@ -0,0 +1,222 @@
+/**
+ *  \file BME280_Format.cpp
+ *  \brief BOSCH BME280 Sensor Library. Allocation-free Formatting.
+ *
+ *  \details Library C Code File
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include "BME280_Format.h"
+
+/**
+ *  \brief Attach Buffer
+ *
+ *  \param [in] buf Buffer of the Caller
+ *  \param [in] size Size of the Buffer in Bytes, the terminating '\0' included
+ */
+BME280_Format::BME280_Format(char *buf, size_t size){
+	_buf  = buf;
+	_size = size;
+	clear();
+}
+
+/**
+ *  \brief Empty the Buffer and reset the Overflow Flag
+ */
+void BME280_Format::clear(void){
+	_len = 0;
+	_overflow = false;
+	if (_size){
+		_buf[0] = '\0';
+	}
+}
+
+/**
+ *  \brief Length of the Text in the Buffer
+ *
+ *  \return Number of Characters without the terminating '\0'
+ */
+size_t BME280_Format::length(void){
+	return _len;
+}
+
+/**
+ *  \brief Overflow Flag
+ *
+ *  \return True if a Record did not fit into the Buffer since the last 'clear()'
+ */
+bool BME280_Format::overflow(void){
+	return _overflow;
+}
+
+/**
+ *  \brief Append Text
+ *
+ *  \param [in] s Zero terminated String
+ *  \return False if the Buffer is too small, the Buffer is left unchanged then
+ */
+bool BME280_Format::text(const char *s){
+	size_t start = _len;
+	while (*s){
+		if ( !put(*s++) ){
+			return rollback(start);
+		}
+	}
+	return true;
+}
+
+/**
+ *  \brief Append Fixed-Point Decimal
+ *
+ *  \param [in] value Integer Value
+ *  \param [in] decimals Number of Digits behind the Decimal Point, 0 ... BME280_FORMAT_DECIMALS. Value "5123" with 2 Decimals is written as "51.23"
+ *  \return False if the Buffer is too small or 'decimals' is out of Range, the Buffer is left unchanged then
+ *
+ *  \details Digits are built from the Right in a small Stack Buffer, nothing is allocated
+ *  \details At most 10 Digits of the Value plus the leading Zero of "0.xxx", so the Stack Buffer always holds the whole Number
+ */
+bool BME280_Format::decimal(int32_t value, uint8_t decimals){
+	char     digits[BME280_FORMAT_DECIMALS + 2];
+	uint8_t  n = 0;
+	uint32_t u = (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+	size_t   start = _len;
+
+	if (decimals > BME280_FORMAT_DECIMALS){
+		return false;
+	}
+
+	do {
+		digits[n++] = '0' + (char)(u % 10);
+		u /= 10;
+	} while (u || n <= decimals);
+
+	if (value < 0 && !put('-')){
+		return rollback(start);
+	}
+	while (n){
+		if (n == decimals && !put('.')){
+			return rollback(start);
+		}
+		if ( !put(digits[--n]) ){
+			return rollback(start);
+		}
+	}
+	return true;
+}
+
+/**
+ *  \brief Append Sample as plain Text
+ *
+ *  \param [in] s Compensated Sample
+ *  \return False if the Buffer is too small, the Buffer is left unchanged then
+ *
+ *  \details Output value of "23.45 C 96386 Pa 46.33 %rH"
+ */
+bool BME280_Format::plain(const BME280_SAMPLE *s){
+	size_t start = _len;
+	if ( decimal(s->temperature, 2) && text(" C ") &&
+		 decimal((int32_t)s->pressure) && text(" Pa ") &&
+		 decimal(humidity_centi(s->humidity), 2) && text(" %rH") ){
+		return true;
+	}
+	return rollback(start);
+}
+
+/**
+ *  \brief Append Sample as CSV
+ *
+ *  \param [in] s Compensated Sample
+ *  \return False if the Buffer is too small, the Buffer is left unchanged then
+ *
+ *  \details Output value of "23.45,96386,46.33" for Temperature in DegC, Pressure in Pa, Humidity in %rH
+ */
+bool BME280_Format::csv(const BME280_SAMPLE *s){
+	size_t start = _len;
+	if ( decimal(s->temperature, 2) && put(',') &&
+		 decimal((int32_t)s->pressure) && put(',') &&
+		 decimal(humidity_centi(s->humidity), 2) ){
+		return true;
+	}
+	return rollback(start);
+}
+
+/**
+ *  \brief Append Sample as JSON Object
+ *
+ *  \param [in] s Compensated Sample
+ *  \return False if the Buffer is too small, the Buffer is left unchanged then
+ *
+ *  \details Output value of {"temperature":23.45,"pressure":96386,"humidity":46.33}
+ */
+bool BME280_Format::json(const BME280_SAMPLE *s){
+	size_t start = _len;
+	if ( text("{\"temperature\":") && decimal(s->temperature, 2) &&
+		 text(",\"pressure\":") && decimal((int32_t)s->pressure) &&
+		 text(",\"humidity\":") && decimal(humidity_centi(s->humidity), 2) && put('}') ){
+		return true;
+	}
+	return rollback(start);
+}
+
+/**
+ *  \brief Append Sample as InfluxDB Line Protocol
+ *
+ *  \param [in] measurement Measurement Name, optional with Tags, e.g. "bme280,node=kitchen"
+ *  \param [in] s Compensated Sample
+ *  \return False if the Buffer is too small, the Buffer is left unchanged then
+ *
+ *  \details Output value of "bme280 temperature=23.45,pressure=96386,humidity=46.33"
+ *  \details No Timestamp, the Server uses its Time of Arrival
+ */
+bool BME280_Format::influx(const char *measurement, const BME280_SAMPLE *s){
+	size_t start = _len;
+	if ( text(measurement) &&
+		 text(" temperature=") && decimal(s->temperature, 2) &&
+		 text(",pressure=") && decimal((int32_t)s->pressure) &&
+		 text(",humidity=") && decimal(humidity_centi(s->humidity), 2) ){
+		return true;
+	}
+	return rollback(start);
+}
+
+/**
+ *  \brief Append one Character
+ *
+ *  \param [in] c Character
+ *  \return False if there is no Space left for the Character and the terminating '\0'
+ */
+bool BME280_Format::put(char c){
+	if (_len + 1 >= _size){
+		_overflow = true;
+		return false;
+	}
+	_buf[_len++] = c;
+	_buf[_len] = '\0';
+	return true;
+}
+
+/**
+ *  \brief Cut the Buffer back to a previous Length
+ *
+ *  \param [in] len Length before the failed Record
+ *  \return Always False, to be returned by the failed Record
+ */
+bool BME280_Format::rollback(size_t len){
+	_len = len;
+	if (_size){
+		_buf[_len] = '\0';
+	}
+	return false;
+}
+
+/**
+ *  \brief Humidity from Q22.10 to 0.01 %rH
+ *
+ *  \param [in] H Humidity in %RH in Q22.10 format
+ *  \return Humidity in %rH, resolution is 0.01 %rH, rounded
+ */
+int32_t BME280_Format::humidity_centi(uint32_t H){
+	return (int32_t)((H * 100 + 512) >> 10);
+}
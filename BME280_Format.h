@@ -0,0 +1,56 @@
+/**
+ *  \file BME280_Format.h
+ *  \brief BOSCH BME280 Sensor Library. Allocation-free Formatting.
+ *
+ *  \details Library Definition File
+ *  \details Writes compensated Samples as Text, CSV, JSON or InfluxDB Line Protocol into a Buffer of the Caller
+ *  \details Integer only, no Heap, no 'String', no printf
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_FORMAT_H__
+#define __BME280_FORMAT_H__
+
+#include "BME280_I2C.h"
+
+/***********************************************************************
+ *  BME280 FORMAT Settings
+ *  BME280_FORMAT_DECIMALS  Most Digits behind the Decimal Point 'decimal()' accepts,
+ *                          an int32_t has 10 Digits, so more would only add leading Zeros
+ **********************************************************************/
+#define BME280_FORMAT_DECIMALS			10
+
+/***********************************************************************
+ *  BME280_FORMAT CLASS
+ **********************************************************************/
+class BME280_Format{
+	public:
+
+		BME280_Format( char *buf, size_t size );
+
+		void	 clear(void);
+		size_t	 length(void);
+		bool	 overflow(void);
+
+		bool	 text( const char *s );
+		bool	 decimal( int32_t value, uint8_t decimals = 0 );
+
+		bool	 plain( const BME280_SAMPLE *s );
+		bool	 csv( const BME280_SAMPLE *s );
+		bool	 json( const BME280_SAMPLE *s );
+		bool	 influx( const char *measurement, const BME280_SAMPLE *s );
+
+	private:
+		bool	 put( char c );
+		bool	 rollback( size_t len );
+		int32_t	 humidity_centi( uint32_t H );
+
+		char	*_buf				= NULL;
+		size_t	 _size				= 0;
+		size_t	 _len				= 0;
+		bool	 _overflow			= false;
+};
+
+#endif
@@ -8,11 +8,29 @@
  *  \details BSD license, all text above must be included in any redistribution
  */
  
-#include "Arduino.h"
-#include <Wire.h>
 #include "BME280_I2C.h"
 
-BME280_I2C::BME280_I2C(){}
+#if BME280_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+/**
+ *  \brief Default ioctl of the Linux Backend
+ *
+ *  \details Thin Wrapper, so 'ioctl()' fits 'BME280_IOCTL' and can be replaced by a Fake
+ */
+static int bme280_ioctl(int fd, unsigned long request, void *arg){
+	return ioctl(fd, request, arg);
+}
+#endif
+
+/**
+ *  \brief Link Time Check of the Settings, see 'BME280 CONFIG CHECK'
+ */
+extern "C" void BME280_CONFIG_CHECK(void){}
 
 /**
  *  \brief Start Sensor
@@ -108,30 +126,22 @@ void BME280_I2C::normal(void) {
  *  \param [in] t_sb See Description 'BME280 T_SB Settings | 35' in .h File
  *  \param [in] filter See Description 'BME280 FILTER Settings | 52' in .h File
  *  
- *  \details Set '_t_sb' and '_filter' before writing Configuration Data to BME280
+ *  \details Build the Register Image '_config' before writing Configuration Data to BME280
+ *  \details BME280_REGISTER_CONFIG [7:5] = 't_sb'
+ *  \details BME280_REGISTER_CONFIG [4:2] = 'filter'
+ *  \details BME280_REGISTER_CONFIG [1:0] = 'spi3w_en' (Ignored for I2C)
  */
 void BME280_I2C::filter_config(uint8_t t_sb,uint8_t filter){
-	_t_sb = t_sb;
-	_filter = filter;
+	_config = ((t_sb & 0b111) << 5) | ((filter & 0b111) << 2);
 }
 
 /**
  *  \brief Write Filter and StandBy Time to BME280
  *  
- *  \details Build the Byte, that contains Filter and StandBy Time, then write it to 'BME280_REGISTER_CONFIG'
- *  \details BME280_REGISTER_CONFIG [7:5] = 't_sb'
- *  \details BME280_REGISTER_CONFIG [4:2] = 'filter'
- *  \details BME280_REGISTER_CONFIG [1:0] = 'spi3w_en' (Ignored for I2C)
+ *  \details Write the Register Image '_config' to 'BME280_REGISTER_CONFIG'
  */
 void BME280_I2C::filter_write(void) {
-	uint8_t config = 0;
-	config = _t_sb;
-	config = config << 3;
-	config += _filter;
-	config = config << 2;
-	config += 0b00;
-	
-    writeU8(BME280_REGISTER_CONFIG, config);
+    writeU8(BME280_REGISTER_CONFIG, _config);
 }
 
 /**
@@ -141,12 +151,14 @@ void BME280_I2C::filter_write(void) {
  *  \param [in] osrs_t See Description 'BME280 OSRS Settings | 18' in .h File
  *  \param [in] osrs_h See Description 'BME280 OSRS Settings | 18' in .h File
  *  
- *  \details Set 'osrs_t','osrs_p' and 'osrs_h' before writing Configuration Data to BME280
+ *  \details Build the Register Images '_ctrl_meas' and '_ctrl_hum' before writing Configuration Data to BME280
+ *  \details BME280_REGISTER_CONTROL [7:5] = 'osrs_t'
+ *  \details BME280_REGISTER_CONTROL [4:2] = 'osrs_p'
+ *  \details BME280_REGISTER_CONTROLHUMID [2:0] = 'osrs_h'
  */
 void BME280_I2C::osrs_config(uint8_t osrs_p,uint8_t osrs_t,uint8_t osrs_h){
-	_osrs_p = osrs_p;
-	_osrs_t = osrs_t;
-	_osrs_h = osrs_h;
+	_ctrl_meas = ((osrs_t & 0b111) << 5) | ((osrs_p & 0b111) << 2);
+	_ctrl_hum  = osrs_h & 0b111;
 }
 
 /**
@@ -154,100 +166,259 @@ void BME280_I2C::osrs_config(uint8_t osrs_p,uint8_t osrs_t,uint8_t osrs_h){
  *  
  *  \param [in] mode 0b00-Sleep; 0b01-Forced; 0b11-Normal
  *  
- *  \details Build the Byte, that contains Oversampling for T, P and Mode, then write it to 'BME280_REGISTER_CONTROL'
- *  \details BME280_REGISTER_CONTROL [7:5] = 'osrs_t'
- *  \details BME280_REGISTER_CONTROL [4:2] = 'osrs_p'
+ *  \details Oversampling for Humidity is written first to 'BME280_REGISTER_CONTROLHUMID', it gets active with the next Write of 'BME280_REGISTER_CONTROL'
+ *  \details Then the Register Image '_ctrl_meas' and the Mode are written to 'BME280_REGISTER_CONTROL'
  *  \details BME280_REGISTER_CONTROL [1:0] = 'mode'
- *  \details Oversampling for Humidity is written directly to 'BME280_REGISTER_CONTROLHUMID'
- *  \details BME280_REGISTER_CONTROLHUMID [2:0] = 'osrs_h'
+ *  \details Linux: both Registers in one Write Message of Register/Value Pairs, so 'forced()' is one ioctl
  */
 void BME280_I2C::osrs_mode_write(uint8_t mode) {
-	uint8_t ctrl_meas = 0;
-	ctrl_meas = _osrs_t;								
-	ctrl_meas = ctrl_meas << 3;
-	ctrl_meas += _osrs_p;
-	ctrl_meas = ctrl_meas << 2;
-	
-    writeU8(BME280_REGISTER_CONTROLHUMID, _osrs_h);
-    writeU8(BME280_REGISTER_CONTROL, ctrl_meas + mode);
+#if BME280_LINUX
+    uint8_t d[4] = { BME280_REGISTER_CONTROLHUMID, _ctrl_hum, BME280_REGISTER_CONTROL, (uint8_t)(_ctrl_meas | (mode & 0b11)) };
+    write_pairs(d, sizeof(d));
+#else
+    writeU8(BME280_REGISTER_CONTROLHUMID, _ctrl_hum);
+    writeU8(BME280_REGISTER_CONTROL, _ctrl_meas | (mode & 0b11));
+#endif
+    _mode = mode & 0b11;
 }
 
 
-void BME280_I2C::read_data_burst(void){
-	uint8_t value;
-	Wire.beginTransmission((uint8_t)_i2caddr);
-	Wire.write((uint8_t)0xF7);
-	Wire.endTransmission();
-	Wire.requestFrom((uint8_t)_i2caddr, (uint8_t)8);
-	_adc_P = (Wire.read() << 16) | (Wire.read() << 8) | Wire.read();
-	_adc_P = _adc_P >> 4;
-	_adc_T = (Wire.read() << 16) | (Wire.read() << 8) | Wire.read();
-	_adc_T = _adc_T >> 4;
-	_adc_H = (Wire.read() << 8) | Wire.read() ;
-	value = 0;
+/**
+ *  \brief Burst Read of the ADC Registers
+ *  
+ *  \return Success Flag of the Bus Transfer, the raw Values are unchanged on Failure
+ *  
+ *  \details One Transaction of 8 Bytes from 0xF7 to 0xFE. The Registers are shadowed by the BME280 during a Burst Read, so adc_P, adc_T and adc_H belong to the same Measurement
+ */
+bool BME280_I2C::read_data_burst(void){
+	uint8_t d[8];
+	if ( !read_regs(BME280_REGISTER_PRESSUREDATA, d, sizeof(d)) ){
+		return false;
+	}
+	_adc_P = ((uint32_t)d[0] << 12) | ((uint32_t)d[1] << 4) | (d[2] >> 4);
+	_adc_T = ((uint32_t)d[3] << 12) | ((uint32_t)d[4] << 4) | (d[5] >> 4);
+	_adc_H = ((uint32_t)d[6] << 8) | d[7];
+	return true;
 }
 
 /**
  *  \brief Read adc_T, adc_P, adc_H in 'Burst Mode'
  *  
+ *  \return Success Flag. On a Bus Failure the last Sample is kept and nothing is passed to the Sink
+ *  
  *  \details Before reading, change BME280 Mode from 'Sleep' to 'Forced or 'Normal'
  *  \details Reads adc_T, adc_P, adc_H by doing a very fast 'Burst Read' on 0xF7 to 0xFE
  *  \details After reading, change BME280 Mode to 'Sleep'
  */
-void BME280_I2C::read_adc_burst(void){
-	read_data_burst();
-	compensate_T_int32(_adc_T);						// calculate current '_t_fine' with double precision
+bool BME280_I2C::read_adc_burst(void){
+	if ( !read_data_burst() ){
+		return false;
+	}
+	read_done();
+	return true;
 }
 
+#if BME280_USE_SINGLE
 /**
  *  \brief Read adc_T, adc_P, adc_H in 'Single Mode'
  *  
+ *  \return Success Flag. On a Bus Failure the last Sample is kept and nothing is passed to the Sink
+ *  
  *  \details Before reading, change BME280 Mode from 'Sleep' to 'Forced or 'Normal'
  *  \details Reads adc_T, adc_P, adc_H by polling every single register by its address
  *  \details After reading, change BME280 Mode to 'Sleep'
  */
-void BME280_I2C::read_adc_single(void){
-	read_adc_P();
-	read_adc_T();
-	read_adc_H();
-	compensate_T_int32(_adc_T);						// calculate current '_t_fine' with double precision
+bool BME280_I2C::read_adc_single(void){
+	int32_t adc_P, adc_T, adc_H;
+	if ( !read_adc_P(&adc_P) || !read_adc_T(&adc_T) || !read_adc_H(&adc_H) ){
+		return false;
+	}
+	_adc_P = adc_P;
+	_adc_T = adc_T;
+	_adc_H = adc_H;
+	read_done();
+	return true;
 }
 
 /**
  *  \brief Read adc_P in 'Single Mode'
  *  
- *  \details Build the _adc_P Value from Register 0xFA, 0xFB and 0xFC
+ *  \param [out] adc raw Pressure
+ *  \return Success Flag of the Bus Transfer
+ *  
+ *  \details Build the _adc_P Value from Register 0xF7, 0xF8 and 0xF9
  *  \details _adc_P is expected to be received in 20 bit format, positive, stored in a 32 bit signed integer
- *  \details Humidity is expected to be received in 16 bit format, positive, stored in a 32 bit signed integer
  */
-void BME280_I2C::read_adc_P(void){
-	_adc_P = 0;
-	_adc_P = readU24(BME280_REGISTER_PRESSUREDATA);
-	_adc_P = _adc_P >> 4;
+bool BME280_I2C::read_adc_P(int32_t *adc){
+	uint8_t d[3];
+	if ( !read_regs(BME280_REGISTER_PRESSUREDATA, d, sizeof(d)) ){
+		return false;
+	}
+	*adc = ((uint32_t)d[0] << 12) | ((uint32_t)d[1] << 4) | (d[2] >> 4);
+	return true;
 }
 
 /**
  *  \brief Read adc_T in 'Single Mode'
  *  
- *  \details Build the _adc_T Value from Register 0xF7, 0xF8 and 0xF9
+ *  \param [out] adc raw Temperature
+ *  \return Success Flag of the Bus Transfer
+ *  
+ *  \details Build the _adc_T Value from Register 0xFA, 0xFB and 0xFC
  *  \details _adc_T is expected to be received in 20 bit format, positive, stored in a 32 bit signed integer
  */
-void BME280_I2C::read_adc_T(void){
-	_adc_T = 0;
-	_adc_T = readU24(BME280_REGISTER_TEMPDATA);
-	_adc_T = _adc_T >> 4;
+bool BME280_I2C::read_adc_T(int32_t *adc){
+	uint8_t d[3];
+	if ( !read_regs(BME280_REGISTER_TEMPDATA, d, sizeof(d)) ){
+		return false;
+	}
+	*adc = ((uint32_t)d[0] << 12) | ((uint32_t)d[1] << 4) | (d[2] >> 4);
+	return true;
 }
 
 /**
  *  \brief Read adc_H in 'Single Mode'
  *  
+ *  \param [out] adc raw Humidity
+ *  \return Success Flag of the Bus Transfer
+ *  
  *  \details Build the _adc_H Value from Register 0xFD, 0xFE
  *  \details _adc_H is expected to be received in 16 bit format, positive, stored in a 32 bit signed integer
  */
-void BME280_I2C::read_adc_H(void){
-	_adc_H = 0;
-	_adc_H = readU16(BME280_REGISTER_HUMIDDATA);
-}	
+bool BME280_I2C::read_adc_H(int32_t *adc){
+	uint8_t d[2];
+	if ( !read_regs(BME280_REGISTER_HUMIDDATA, d, sizeof(d)) ){
+		return false;
+	}
+	*adc = ((uint32_t)d[0] << 8) | d[1];
+	return true;
+}
+#endif
+
+/**
+ *  \brief Finish a Reading
+ *  
+ *  \details Calculate current '_t_fine', then hand the compensated Sample to the attached Sink
+ */
+void BME280_I2C::read_done(void){
+#if BME280_USE_LUT
+	compensate_T_lut(_adc_T);						// calculate current '_t_fine' from the Table
+#else
+	compensate_T_int32(_adc_T);						// calculate current '_t_fine' with double precision
+#endif
+#if BME280_USE_SINK
+	if (_sink){
+		BME280_SAMPLE s;
+		sample(&s);
+		_sink(_sink_ctx, &s);
+	}
+#endif
+}
+
+#if BME280_USE_SINK
+/**
+ *  \brief Attach a Sample Sink to the Read Path
+ *  
+ *  \param [in] fn Called with every compensated Sample of 'read_adc_burst()', 'read_adc_single()' and accepted 'read_adc_event()'. NULL detaches
+ *  \param [in] ctx Passed to 'fn', e.g. a 'BME280_Stats' Aggregator
+ *  
+ *  \details Samples rejected by the Deadband are not passed, so nothing is compensated for them
+ */
+void BME280_I2C::sink_attach(BME280_SINK fn, void *ctx){
+	_sink     = fn;
+	_sink_ctx = ctx;
+}
+#endif
+
+#if BME280_USE_DEADBAND
+/**
+ *  \brief Set Deadband for 'read_adc_event()'
+ *
+ *  \param [in] T Temperature Threshold in DegC
+ *  \param [in] P Pressure Threshold in Pa
+ *  \param [in] H Humidity Threshold in %rH
+ *
+ *  \details Translate the physical Thresholds once into raw ADC Units, so 'read_adc_event()' never has to compensate
+ *  \details The Sensitivity (Unit per LSB) is the Derivative of the double Formulas, evaluated at the last Reading
+ *  \details Without a Reading (right after 'begin()') it is evaluated at 25 DegC instead
+ *  \details Call again after large Temperature Changes
+ *  \details A Threshold of 0 accepts every Sample on this Channel
+ */
+void BME280_I2C::deadband_config(float T, float P, float H){
+	float x, slope, t_fine;
+
+	if (_adc_T){
+		x = ((float)_adc_T) / 131072.0f - ((float)_bme280_calib.dig_T1) / 8192.0f;
+		t_fine = (float)_t_fine;
+	} else {
+		t_fine = 25.0f * 5120.0f;					// no Reading yet: nominal 25 DegC
+		x = t_fine / (8.0f * (float)_bme280_calib.dig_T2);	// t_fine = x * (8 * dig_T2 + x * dig_T3), solved by Iteration
+		for (uint8_t i = 0 ; i < 3 ; i++){
+			x = t_fine / (8.0f * (float)_bme280_calib.dig_T2 + x * (float)_bme280_calib.dig_T3);
+		}
+	}
+	slope = (((float)_bme280_calib.dig_T2) / 16384.0f + ((float)_bme280_calib.dig_T3) * x / 65536.0f) / 5120.0f;
+	_db_T = (slope == 0.0f) ? 0 : (int32_t)ceilf(fabsf(T / slope));
+
+	x = (t_fine / 2.0f) - 64000.0f;
+	x = (((float)_bme280_calib.dig_P3) * x * x / 524288.0f + ((float)_bme280_calib.dig_P2) * x) / 524288.0f;
+	x = (1.0f + x / 32768.0f) * ((float)_bme280_calib.dig_P1);
+	slope = 6250.0f / x;
+	_db_P = (x == 0.0f) ? 0 : (int32_t)ceilf(fabsf(P / slope));
+
+	x = t_fine - 76800.0f;
+	slope = ((float)_bme280_calib.dig_H2) / 65536.0f * (1.0f + ((float)_bme280_calib.dig_H6) / 67108864.0f * x * (1.0f + ((float)_bme280_calib.dig_H3) / 67108864.0f * x));
+	_db_H = (slope == 0.0f) ? 0 : (int32_t)ceilf(fabsf(H / slope));
+
+	_ref_adc_P = _adc_P;
+	_ref_adc_T = _adc_T;
+	_ref_adc_H = _adc_H;
+}
+
+/**
+ *  \brief Read adc_T, adc_P, adc_H in 'Burst Mode' and reject unchanged Samples
+ *
+ *  \return True if at least one Channel left its Deadband, else False. False on a Bus Failure
+ *
+ *  \details Same as 'read_adc_burst()', but '_t_fine' is only calculated for changed Samples
+ *  \details If False is returned, there is nothing new to compensate or to send. The raw Values of the last
+ *  \details accepted Sample are kept, so 'raw_X()', 'pressure()', 'humidity()' and 'sample()' stay consistent with '_t_fine'
+ */
+bool BME280_I2C::read_adc_event(void){
+	int32_t adc_P = _adc_P, adc_T = _adc_T, adc_H = _adc_H;
+	if ( !read_data_burst() ){
+		return false;
+	}
+	if ( !adc_changed() ){
+		_adc_P = adc_P;
+		_adc_T = adc_T;
+		_adc_H = adc_H;
+		return false;
+	}
+	read_done();
+	return true;
+}
+
+/**
+ *  \brief Compare raw ADC Values against the last accepted Sample
+ *
+ *  \return True if at least one Channel moved by its Deadband or more
+ *
+ *  \details On Change, all three Reference Values are updated together, so the Deadband does not drift
+ */
+bool BME280_I2C::adc_changed(void){
+	if ( labs(_adc_P - _ref_adc_P) < _db_P &&
+		 labs(_adc_T - _ref_adc_T) < _db_T &&
+		 labs(_adc_H - _ref_adc_H) < _db_H ){
+		return false;
+	}
+	_ref_adc_P = _adc_P;
+	_ref_adc_T = _adc_T;
+	_ref_adc_H = _adc_H;
+	return true;
+}
+#endif
+
 
 /**
  *  \brief Compensate given 'adc_P' with Factory Calibration Data
@@ -283,6 +454,7 @@ uint32_t BME280_I2C::compensate_P_int32(int32_t adc_P){
 	return P;
 }
 
+#if BME280_USE_INT64
 /**
  *  \brief Compensate given 'adc_P' with Factory Calibration Data
  *  
@@ -310,7 +482,9 @@ uint32_t BME280_I2C::compensate_P_int64(int32_t adc_P){
 	P = ((P + var1 + var2) >> 8) + (((int64_t)_bme280_calib.dig_P7)<<4);
 	return (uint32_t)P/256;
 }
+#endif
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Compensate given 'adc_P' with Factory Calibration Data
  *  
@@ -335,10 +509,11 @@ double BME280_I2C::compensate_P_double(int32_t adc_P) {
 	P = (P - (var2 / 4096.0)) * 6250.0 / var1;
 	var1 = ((double)_bme280_calib.dig_P9) * P * P / 2147483648.0;
 	var2 = P * ((double)_bme280_calib.dig_P8) / 32768.0;
-	P = P + (var1 + var2 + ((double)_bme280_calib.dig_P7)) / 256.0;
+	P = P + (var1 + var2 + ((double)_bme280_calib.dig_P7)) / 16.0;
 	
 	return P;
 }
+#endif
 
 /**
  *  \brief Compensate given 'adc_T' with Factory Calibration Data
@@ -359,6 +534,7 @@ int32_t BME280_I2C::compensate_T_int32(int32_t adc_T){
 	return T;
 }
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Compensate given 'adc_T' with Factory Calibration Data
  *  
@@ -377,6 +553,7 @@ double BME280_I2C::compensate_T_double(int32_t adc_T){
 	
 	return T;
 }
+#endif
 
 /**
  *  \brief Compensate given 'adc_H' with Factory Calibration Data
@@ -404,6 +581,7 @@ uint32_t BME280_I2C::compensate_H_int32(int32_t adc_H) {
 	return v_x1_u32r>>12;
 }
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Compensate given 'adc_H' with Factory Calibration Data
  *  
@@ -426,7 +604,116 @@ double BME280_I2C::compensate_H_double(int32_t adc_H) {
 	
 	return H;
 }
+#endif
+
+#if BME280_USE_LUT
+/**
+ *  \brief Compensate given 'adc_T' with the Per-Device Table
+ *  
+ *  \param [in] adc_T 20 bit format, positive, stored in a 32 bit signed integer
+ *  \return Temperature in DegC, resolution is 0.01 DegC. Output value of "5123" equals 51.23 DegC
+ *  
+ *  \details 't_fine' is interpolated between two Nodes of '_lut_T', then rounded like 'compensate_T_int32()'
+ *  \details One Multiplication instead of five, see 'BME280 LUT Settings' in .h File for the Error
+ */
+int32_t BME280_I2C::compensate_T_lut(int32_t adc_T){
+	_t_fine = lut_lerp(_lut_T, (uint32_t)adc_T & 0xFFFFF, 20 - BME280_LUT_T_BITS);
+	return (_t_fine * 5 + 128) >> 8;
+}
+
+/**
+ *  \brief Compensate given 'adc_H' with the Per-Device Table
+ *  
+ *  \param [in] adc_H 16 bit format, positive, stored in a 32 bit signed integer
+ *  \return Humidity in %RH as unsigned 32 bit integer in Q22.10 format (22 integer and 10 fractional bits)
+ *  
+ *  \details Same Formula as 'compensate_H_int32()', but the Temperature dependent Factor (dig_H2, dig_H3, dig_H6) is interpolated from '_lut_H'
+ *  \details The Offset (dig_H4, dig_H5) is linear in 't_fine' and calculated directly. Outside of the Table the Factor is calculated exactly,
+ *  \details in 64 Bit, below -51.2 and above 153.6 DegC only
+ */
+uint32_t BME280_I2C::compensate_H_lut(int32_t adc_H){
+	int32_t  pos = _t_fine - BME280_LUT_H_BASE;
+	int32_t  v   = _t_fine - ((int32_t)76800);
+	int32_t  factor, x;
+	
+	if (pos >= 0 && pos < (1L << BME280_LUT_H_SPAN_BITS)){
+		factor = lut_lerp(_lut_H, (uint32_t)pos, BME280_LUT_H_SPAN_BITS - BME280_LUT_H_BITS);
+	} else {
+		factor = (int32_t)lut_h_factor(_t_fine);
+	}
+	
+	x = (((adc_H << 14) - (((int32_t)_bme280_calib.dig_H4) << 20) - (((int32_t)_bme280_calib.dig_H5) * v)) + ((int32_t)16384)) >> 15;
+	x = x * factor;
+	x = (x - (((((x >> 15) * (x >> 15)) >> 7) * ((int32_t)_bme280_calib.dig_H1)) >> 4));
 	
+	x = (x < 0 ? 0 : x);
+	x = (x > 419430400 ? 419430400 : x);
+	
+	return x>>12;
+}
+
+/**
+ *  \brief Linear Interpolation between two Table Nodes, 32 Bit Multiplications only
+ *  
+ *  \param [in] lut Table
+ *  \param [in] pos Position, Node Index in the upper Bits, Fraction in the lower 'shift' Bits
+ *  \param [in] shift Fraction Bits, 8 - 16
+ *  \return lut[i] + floor((lut[i + 1] - lut[i]) * frac / 2^shift), the same as with a 64 Bit Product
+ *  
+ *  \details The Node Difference is split at Bit 8: (d >> 8) * frac and (d & 0xFF) * frac both fit 32 Bit
+ *  \details for |d| < 2^23, no '__muldi3' on 8 Bit Targets
+ */
+int32_t BME280_I2C::lut_lerp(const int32_t *lut, uint32_t pos, uint8_t shift){
+	uint32_t i    = pos >> shift;
+	int32_t  frac = pos & ((1L << shift) - 1);
+	int32_t  d    = lut[i + 1] - lut[i];
+	
+	return lut[i] + ((((d >> 8) * frac) + (((d & 0xFF) * frac) >> 8)) >> (shift - 8));
+}
+
+/**
+ *  \brief Build the Per-Device Tables
+ *  
+ *  \details Called by 'read_coeff()'. Every Node is the exact Value of the BOSCH Integer Formula
+ */
+void BME280_I2C::lut_build(void){
+	for (uint16_t i = 0 ; i <= (1 << BME280_LUT_T_BITS) ; i++){
+		_lut_T[i] = (int32_t)lut_t_fine((int32_t)i << (20 - BME280_LUT_T_BITS));
+	}
+	for (uint16_t i = 0 ; i <= (1 << BME280_LUT_H_BITS) ; i++){
+		_lut_H[i] = (int32_t)lut_h_factor(BME280_LUT_H_BASE + ((int32_t)i << (BME280_LUT_H_SPAN_BITS - BME280_LUT_H_BITS)));
+	}
+}
+
+/**
+ *  \brief 't_fine' of 'compensate_T_int32()' in 64 Bit
+ *  
+ *  \param [in] adc_T 0 - 2^20, the last Node included
+ *  \return t_fine, identical to 'compensate_T_int32()' where that does not overflow
+ */
+int64_t BME280_I2C::lut_t_fine(int32_t adc_T){
+	int64_t var1, var2;
+	
+	var1 = ((((int64_t)(adc_T>>3) - ((int64_t)_bme280_calib.dig_T1<<1))) * ((int64_t)_bme280_calib.dig_T2)) >> 11;
+	var2 = (((((int64_t)(adc_T>>4) - ((int64_t)_bme280_calib.dig_T1)) * ((int64_t)(adc_T>>4) - ((int64_t)_bme280_calib.dig_T1))) >> 12) * ((int64_t)_bme280_calib.dig_T3)) >> 14;
+	return var1 + var2;
+}
+
+/**
+ *  \brief Temperature dependent Humidity Factor of 'compensate_H_int32()' in 64 Bit
+ *  
+ *  \param [in] t_fine Fine Temperature
+ *  \return Factor, identical to the second Operand of the Product in 'compensate_H_int32()'
+ */
+int64_t BME280_I2C::lut_h_factor(int32_t t_fine){
+	int64_t v = (int64_t)t_fine - 76800;
+	
+	return (((((((v * ((int64_t)_bme280_calib.dig_H6)) >> 10) *
+			(((v * ((int64_t)_bme280_calib.dig_H3)) >> 11) + ((int64_t)32768))) >> 10) +
+			((int64_t)2097152)) * ((int64_t)_bme280_calib.dig_H2) + 8192) >> 14);
+}
+#endif
+
 /**
  *  \brief Temperature
  *  
@@ -435,9 +722,14 @@ double BME280_I2C::compensate_H_double(int32_t adc_H) {
  *  \details Calculate Temperature by compensating '_adc_T' with Factory Calibration Data
  */
 int32_t BME280_I2C::temperature(void){
+#if BME280_USE_LUT
+	return compensate_T_lut(_adc_T);
+#else
 	return compensate_T_int32(_adc_T);
+#endif
 }
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Temperature with 'Double Precision'
  *  
@@ -448,6 +740,7 @@ int32_t BME280_I2C::temperature(void){
 double BME280_I2C::temperature_dbl(void){
 	return compensate_T_double(_adc_T);
 }
+#endif
 
 /**
  *  \brief Pressure
@@ -460,6 +753,7 @@ int32_t BME280_I2C::pressure(void){
 	return compensate_P_int32(_adc_P);
 }
 
+#if BME280_USE_INT64
 /**
  *  \brief Pressure
  *  
@@ -470,7 +764,9 @@ int32_t BME280_I2C::pressure(void){
 int32_t BME280_I2C::pressure_i64(void){
 	return compensate_P_int64(_adc_P);
 }
+#endif
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Pressure with 'Double Precision'
  *  
@@ -481,6 +777,7 @@ int32_t BME280_I2C::pressure_i64(void){
 double BME280_I2C::pressure_dbl(void){
 	return compensate_P_double(_adc_P);
 }
+#endif
 
 /**
  *  \brief Humidity
@@ -490,9 +787,14 @@ double BME280_I2C::pressure_dbl(void){
  *  \details Calculate Humidity by compensating '_adc_H' with Factory Calibration Data
  */
 int32_t BME280_I2C::humidity(void){
+#if BME280_USE_LUT
+	return compensate_H_lut(_adc_H);
+#else
 	return compensate_H_int32(_adc_H);
+#endif
 }
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Humidity with 'Double Precision'
  *  
@@ -503,184 +805,227 @@ int32_t BME280_I2C::humidity(void){
 double BME280_I2C::humidity_dbl(void){
 	return compensate_H_double(_adc_H);
 }
+#endif
 
 /**
- *  \brief I2C - U8Bit - Write
+ *  \brief Compensated Sample
  *  
- *  \param [in] reg Register Address to write to
- *  \param [in] value Value to write to Register
+ *  \param [out] s Temperature, Pressure and Humidity of the last Reading in 32Bit Integer Precision
  *  
- *  \details Start Transmission on I2C, write the Register Address and Value. Close Transmission after writing
+ *  \details Same as 'temperature()', 'pressure()' and 'humidity()' in one Call
  */
-void BME280_I2C::writeU8(uint8_t reg, uint8_t value){
-	Wire.beginTransmission((uint8_t)_i2caddr);
-	Wire.write((uint8_t)reg);
-	Wire.write((uint8_t)value);
-	Wire.endTransmission();
+void BME280_I2C::sample(BME280_SAMPLE *s){
+#if BME280_USE_LUT
+	s->temperature = compensate_T_lut(_adc_T);
+	s->pressure    = compensate_P_int32(_adc_P);
+	s->humidity    = compensate_H_lut(_adc_H);
+#else
+	s->temperature = compensate_T_int32(_adc_T);
+	s->pressure    = compensate_P_int32(_adc_P);
+	s->humidity    = compensate_H_int32(_adc_H);
+#endif
 }
 
+#if BME280_LINUX
 /**
- *  \brief I2C - U8Bit - Read
+ *  \brief Open Linux I2C Bus
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] device Character Device of the Bus, e.g. "/dev/i2c-1"
+ *  \param [in] ioctl_fn ioctl to use, NULL for the Kernel
+ *  \return Success Flag
  *  
- *  \details Start Transmission on I2C, write the Register Address to BME280, Close Transmission after writing. Then read 1 Byte as Response. 
+ *  \details Call before 'begin()'. The File Descriptor is owned by the Driver and closed by 'bus_close()'
  */
-uint8_t BME280_I2C::readU8(byte reg){
-	uint8_t value;
-	Wire.beginTransmission((uint8_t)_i2caddr);
-	Wire.write((uint8_t)reg);
-	Wire.endTransmission();
-	Wire.requestFrom((uint8_t)_i2caddr, (byte)1);
-	value = Wire.read();
-	return value;
+bool BME280_I2C::bus_open(const char *device, BME280_IOCTL ioctl_fn){
+	int fd;
+	bus_close();
+	fd = open(device, O_RDWR | O_CLOEXEC);
+	if (fd < 0){
+		return false;
+	}
+	bus_attach(fd, ioctl_fn);
+	_fd_owned = true;
+	return true;
 }
 
 /**
- *  \brief I2C - S8Bit - Read
+ *  \brief Attach an open Linux I2C Bus
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] fd File Descriptor of the Bus, or any Number a Fake 'ioctl_fn' understands
+ *  \param [in] ioctl_fn ioctl to use, NULL for the Kernel
  *  
- *  \details Use 'readU8()' to read from I2C, but return a signed integer
+ *  \details The File Descriptor stays owned by the Caller, several Sensors can share one Bus
  */
-int8_t BME280_I2C::readS8(byte reg){
-  return (int8_t)readU8(reg);
+void BME280_I2C::bus_attach(int fd, BME280_IOCTL ioctl_fn){
+	bus_close();
+	_fd       = fd;
+	_fd_owned = false;
+	_ioctl    = ioctl_fn ? ioctl_fn : bme280_ioctl;
 }
 
 /**
- *  \brief I2C - U16Bit - Read
- *  
- *  \param [in] reg Register Address to read from
+ *  \brief Release Linux I2C Bus
  *  
- *  \details Start Transmission on I2C, write the Register Address to BME280, Close Transmission after writing. Then read 2 Bytes as Response. 
+ *  \details Closes the File Descriptor if it was opened by 'bus_open()'
  */
-uint16_t BME280_I2C::readU16(byte reg){
-	uint16_t value;
-	Wire.beginTransmission((uint8_t)_i2caddr);
-	Wire.write((uint8_t)reg);
-	Wire.endTransmission();
-	Wire.requestFrom((uint8_t)_i2caddr, (byte)2);
-	value = (Wire.read() << 8) | Wire.read();
-	return value;
+void BME280_I2C::bus_close(void){
+	if (_fd >= 0 && _fd_owned){
+		close(_fd);
+	}
+	_fd       = -1;
+	_fd_owned = false;
 }
 
 /**
- *  \brief I2C - U16Bit - Read - Little Endian
+ *  \brief I2C - Register Block - Read
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] reg first Register Address to read from
+ *  \param [out] buf Register Values
+ *  \param [in] len Number of Registers, the Address auto-increments
+ *  \return Success Flag
  *  
- *  \details Use 'readU16()' to read from I2C, but with swapped MSB and LSB for LE Encoding
+ *  \details One 'I2C_RDWR' ioctl with two Messages: Register Address write, then 'len' Bytes read after a repeated Start
  */
-uint16_t BME280_I2C::readU16_LE(byte reg){
-  uint16_t temp = readU16(reg);
-  return (temp >> 8) | (temp << 8);
+bool BME280_I2C::read_regs(byte reg, uint8_t *buf, uint8_t len){
+	struct i2c_msg msgs[2] = {
+		{ _i2caddr, 0,        1,   &reg },
+		{ _i2caddr, I2C_M_RD, len, buf  }
+	};
+	struct i2c_rdwr_ioctl_data xfer = { msgs, 2 };
+	if (_fd < 0 || _ioctl(_fd, I2C_RDWR, &xfer) != 2){
+		memset(buf, 0, len);
+		return false;
+	}
+	return true;
 }
 
 /**
- *  \brief I2C - S16Bit - Read
+ *  \brief I2C - U8Bit - Write
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] reg Register Address to write to
+ *  \param [in] value Value to write to Register
  *  
- *  \details Use 'readU16()' to read from I2C, but return a signed integer
+ *  \details One 'I2C_RDWR' ioctl with one Message of Register Address and Value
  */
-int16_t BME280_I2C::readS16(byte reg){
-  return (int16_t)readU16(reg);
+void BME280_I2C::writeU8(uint8_t reg, uint8_t value){
+	uint8_t d[2] = { reg, value };
+	write_pairs(d, sizeof(d));
 }
 
 /**
- *  \brief I2C - S16Bit - Read - Little Endian
+ *  \brief I2C - Register/Value Pairs - Write
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] d Register Address, Value, Register Address, Value, ...
+ *  \param [in] len Bytes in 'd', 2 per Register
  *  
- *  \details Use 'readU16_LE()' to read from I2C, but return a signed integer
+ *  \details One 'I2C_RDWR' ioctl with one Message. The BME280 takes any Number of Pairs in one Write, see Datasheet | 6.2.1
  */
-int16_t BME280_I2C::readS16_LE(byte reg){
-  return (int16_t)readU16_LE(reg);
+void BME280_I2C::write_pairs(uint8_t *d, uint8_t len){
+	struct i2c_msg msg = { _i2caddr, 0, len, d };
+	struct i2c_rdwr_ioctl_data xfer = { &msg, 1 };
+	if (_fd >= 0){
+		_ioctl(_fd, I2C_RDWR, &xfer);
+	}
 }
-
+#else
 /**
- *  \brief I2C - U24Bit - Read
+ *  \brief I2C - Register Block - Read
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] reg first Register Address to read from
+ *  \param [out] buf Register Values
+ *  \param [in] len Number of Registers, the Address auto-increments. Not more than the 'Wire' Buffer
+ *  \return Success Flag
  *  
- *  \details Start Transmission on I2C, write the Register Address to BME280, Close Transmission after writing. Then read 3 Bytes as Response. 
+ *  \details Start Transmission on I2C, write the Register Address to BME280, Close Transmission after writing. Then read 'len' Bytes as Response. 
  */
-uint32_t BME280_I2C::readU24(byte reg){
-	uint32_t value;
+bool BME280_I2C::read_regs(byte reg, uint8_t *buf, uint8_t len){
 	Wire.beginTransmission((uint8_t)_i2caddr);
 	Wire.write((uint8_t)reg);
 	Wire.endTransmission();
-	Wire.requestFrom((uint8_t)_i2caddr, (byte)3);
-	value = Wire.read();
-	value <<= 8;
-	value |= Wire.read();
-	value <<= 8;
-	value |= Wire.read();
-	return value;
+	if ( Wire.requestFrom((uint8_t)_i2caddr, (uint8_t)len) != len ){
+		memset(buf, 0, len);
+		return false;
+	}
+	for (uint8_t i = 0 ; i < len ; i++){
+		buf[i] = Wire.read();
+	}
+	return true;
 }
 
 /**
- *  \brief I2C - U24Bit - Read - Little Endian
+ *  \brief I2C - U8Bit - Write
  *  
- *  \param [in] reg Register Address to read from
+ *  \param [in] reg Register Address to write to
+ *  \param [in] value Value to write to Register
  *  
- *  \details Use 'readU24()' to read from I2C, but with swapped MSB and LSB for LE Encoding
+ *  \details Start Transmission on I2C, write the Register Address and Value. Close Transmission after writing
  */
-uint32_t BME280_I2C::readU24_LE(byte reg){
-  uint32_t temp = readU24(reg);
-  return (temp >> 8) | (temp << 8);
+void BME280_I2C::writeU8(uint8_t reg, uint8_t value){
+	Wire.beginTransmission((uint8_t)_i2caddr);
+	Wire.write((uint8_t)reg);
+	Wire.write((uint8_t)value);
+	Wire.endTransmission();
 }
+#endif
 
 /**
- *  \brief I2C - S24Bit - Read
+ *  \brief I2C - U8Bit - Read
  *  
  *  \param [in] reg Register Address to read from
  *  
- *  \details Use 'readU24()' to read from I2C, but return a signed integer
+ *  \details Use 'read_regs()' for 1 Byte
  */
-int32_t BME280_I2C::readS24(byte reg){
-  return (int32_t)readU24(reg);
+uint8_t BME280_I2C::readU8(byte reg){
+	uint8_t value;
+	read_regs(reg, &value, 1);
+	return value;
 }
 
-/**
- *  \brief I2C - S24Bit - Read - Little Endian
- *  
- *  \param [in] reg Register Address to read from
- *  
- *  \details Use 'readU24_LE()' to read from I2C, but return a signed integer
- */
-int32_t BME280_I2C::readS24_LE(byte reg){
-  return (int32_t)readU24_LE(reg);
-}
 
 /**************************************************************************/
 /*!
     @brief  Reads the factory-set coefficients
+    
+    Two Block Reads: 0x88 - 0xA1 (dig_T1 - dig_P9, dig_H1) and 0xE1 - 0xE7 (dig_H2 - dig_H6)
 */
 /**************************************************************************/
 void BME280_I2C::read_coeff(void){
-    _bme280_calib.dig_T1 = readU16_LE(BME280_REGISTER_DIG_T1);
-    _bme280_calib.dig_T2 = readS16_LE(BME280_REGISTER_DIG_T2);
-    _bme280_calib.dig_T3 = readS16_LE(BME280_REGISTER_DIG_T3);
+    uint8_t tp[BME280_REGISTER_DIG_H1 - BME280_REGISTER_DIG_T1 + 1];
+    uint8_t h[BME280_REGISTER_DIG_H6 - BME280_REGISTER_DIG_H2 + 1];
+    int16_t w[12];
+    
+    read_regs(BME280_REGISTER_DIG_T1, tp, sizeof(tp));
+    read_regs(BME280_REGISTER_DIG_H2, h, sizeof(h));
+    for (uint8_t i = 0 ; i < 12 ; i++){
+        w[i] = (int16_t)(tp[2 * i] | ((uint16_t)tp[2 * i + 1] << 8));	// little endian
+    }
+    
+    _bme280_calib.dig_T1 = (uint16_t)w[0];
+    _bme280_calib.dig_T2 = w[1];
+    _bme280_calib.dig_T3 = w[2];
 
-    _bme280_calib.dig_P1 = readU16_LE(BME280_REGISTER_DIG_P1);
-    _bme280_calib.dig_P2 = readS16_LE(BME280_REGISTER_DIG_P2);
-    _bme280_calib.dig_P3 = readS16_LE(BME280_REGISTER_DIG_P3);
-    _bme280_calib.dig_P4 = readS16_LE(BME280_REGISTER_DIG_P4);
-    _bme280_calib.dig_P5 = readS16_LE(BME280_REGISTER_DIG_P5);
-    _bme280_calib.dig_P6 = readS16_LE(BME280_REGISTER_DIG_P6);
-    _bme280_calib.dig_P7 = readS16_LE(BME280_REGISTER_DIG_P7);
-    _bme280_calib.dig_P8 = readS16_LE(BME280_REGISTER_DIG_P8);
-    _bme280_calib.dig_P9 = readS16_LE(BME280_REGISTER_DIG_P9);
+    _bme280_calib.dig_P1 = (uint16_t)w[3];
+    _bme280_calib.dig_P2 = w[4];
+    _bme280_calib.dig_P3 = w[5];
+    _bme280_calib.dig_P4 = w[6];
+    _bme280_calib.dig_P5 = w[7];
+    _bme280_calib.dig_P6 = w[8];
+    _bme280_calib.dig_P7 = w[9];
+    _bme280_calib.dig_P8 = w[10];
+    _bme280_calib.dig_P9 = w[11];
 
-    _bme280_calib.dig_H1 = readU8(BME280_REGISTER_DIG_H1);
-    _bme280_calib.dig_H2 = readS16_LE(BME280_REGISTER_DIG_H2);
-    _bme280_calib.dig_H3 = readU8(BME280_REGISTER_DIG_H3);
-    _bme280_calib.dig_H4 = (readU8(BME280_REGISTER_DIG_H4) << 4) | (readU8(BME280_REGISTER_DIG_H4+1) & 0xF);
-    _bme280_calib.dig_H5 = (readU8(BME280_REGISTER_DIG_H5+1) << 4) | (readU8(BME280_REGISTER_DIG_H5) >> 4);
-    _bme280_calib.dig_H6 = readS8(BME280_REGISTER_DIG_H6);
+    _bme280_calib.dig_H1 = tp[BME280_REGISTER_DIG_H1 - BME280_REGISTER_DIG_T1];
+    _bme280_calib.dig_H2 = (int16_t)(h[0] | ((uint16_t)h[1] << 8));
+    _bme280_calib.dig_H3 = h[BME280_REGISTER_DIG_H3 - BME280_REGISTER_DIG_H2];
+    _bme280_calib.dig_H4 = (h[BME280_REGISTER_DIG_H4 - BME280_REGISTER_DIG_H2] << 4) | (h[BME280_REGISTER_DIG_H4 + 1 - BME280_REGISTER_DIG_H2] & 0xF);
+    _bme280_calib.dig_H5 = (h[BME280_REGISTER_DIG_H5 + 1 - BME280_REGISTER_DIG_H2] << 4) | (h[BME280_REGISTER_DIG_H5 - BME280_REGISTER_DIG_H2] >> 4);
+    _bme280_calib.dig_H6 = (int8_t)h[BME280_REGISTER_DIG_H6 - BME280_REGISTER_DIG_H2];
+#if BME280_USE_LUT
+    lut_build();
+#endif
 }
 
+#if BME280_USE_DOUBLE
 /**
  *  \brief Altitude from SeaLevel
  *  
@@ -694,4 +1039,203 @@ void BME280_I2C::read_coeff(void){
 double BME280_I2C::altitude_dbl(double seaLevel){
   double atmospheric = pressure_dbl() / 100.0F;
   return 44330.0 * (1.0 - pow(atmospheric / seaLevel, 0.1903));
-}
\ No newline at end of file
+}
+#endif
+
+/**
+ *  \brief Raw Pressure ADC Value
+ *  
+ *  \return Last adc_P, 20 bit format, positive, stored in a 32 bit signed integer
+ */
+int32_t BME280_I2C::raw_P(void){
+	return _adc_P;
+}
+
+/**
+ *  \brief Raw Temperature ADC Value
+ *  
+ *  \return Last adc_T, 20 bit format, positive, stored in a 32 bit signed integer
+ */
+int32_t BME280_I2C::raw_T(void){
+	return _adc_T;
+}
+
+/**
+ *  \brief Raw Humidity ADC Value
+ *  
+ *  \return Last adc_H, 16 bit format, positive, stored in a 32 bit signed integer
+ */
+int32_t BME280_I2C::raw_H(void){
+	return _adc_H;
+}
+
+#if BME280_USE_BUDGET
+/**
+ *  \brief Measurement Time for given Oversampling Rates
+ *  
+ *  \param [in] osrs_p See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] osrs_t See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] osrs_h See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] max False for typical, True for maximum Measurement Time
+ *  \return Measurement Time in us
+ *  
+ *  \details Formula was taken from official BOSCH BME280 Datasheet | 51
+ *  \details t_typ = 1 + [2 * T_os] + [2 * P_os + 0.5] + [2 * H_os + 0.5] ms
+ *  \details t_max = 1.25 + [2.3 * T_os] + [2.3 * P_os + 0.575] + [2.3 * H_os + 0.575] ms
+ *  \details Skipped Measurements are not counted
+ */
+uint32_t BME280_I2C::measure_time_us(uint8_t osrs_p, uint8_t osrs_t, uint8_t osrs_h, bool max){
+	uint32_t os_p = osrs_p ? 1 << ((osrs_p > 5 ? 5 : osrs_p) - 1) : 0;
+	uint32_t os_t = osrs_t ? 1 << ((osrs_t > 5 ? 5 : osrs_t) - 1) : 0;
+	uint32_t os_h = osrs_h ? 1 << ((osrs_h > 5 ? 5 : osrs_h) - 1) : 0;
+	uint32_t t;
+	
+	if (max){
+		t = 1250 + 2300 * os_t;
+		t += os_p ? 2300 * os_p + 575 : 0;
+		t += os_h ? 2300 * os_h + 575 : 0;
+	} else {
+		t = 1000 + 2000 * os_t;
+		t += os_p ? 2000 * os_p + 500 : 0;
+		t += os_h ? 2000 * os_h + 500 : 0;
+	}
+	return t;
+}
+
+/**
+ *  \brief Charge of one Measurement for given Oversampling Rates
+ *  
+ *  \param [in] osrs_p See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] osrs_t See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] osrs_h See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \return Charge in nC (uA * ms)
+ *  
+ *  \details Typical Measurement Time of each Phase multiplied with its typical Supply Current 'BME280_IDD_*'
+ *  \details The Startup Time of 1 ms is counted with the Temperature Current
+ */
+uint32_t BME280_I2C::measure_charge_nC(uint8_t osrs_p, uint8_t osrs_t, uint8_t osrs_h){
+	uint32_t os_p = osrs_p ? 1 << ((osrs_p > 5 ? 5 : osrs_p) - 1) : 0;
+	uint32_t os_t = osrs_t ? 1 << ((osrs_t > 5 ? 5 : osrs_t) - 1) : 0;
+	uint32_t os_h = osrs_h ? 1 << ((osrs_h > 5 ? 5 : osrs_h) - 1) : 0;
+	uint32_t q;
+	
+	q = BME280_IDD_T * (1000 + 2000 * os_t);
+	q += os_p ? BME280_IDD_P * (2000 * os_p + 500) : 0;
+	q += os_h ? BME280_IDD_H * (2000 * os_h + 500) : 0;
+	return q / 1000;
+}
+
+/**
+ *  \brief StandBy Time in 'Normal Mode'
+ *  
+ *  \param [in] t_sb See Description 'BME280 T_SB Settings | 35' in .h File
+ *  \return StandBy Time in us
+ */
+uint32_t BME280_I2C::standby_time_us(uint8_t t_sb){
+	static const uint32_t t_sb_us[8] = { 500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000 };
+	return t_sb_us[t_sb & 0b111];
+}
+
+/**
+ *  \brief Average Supply Current for given Oversampling Rates and Sample Period
+ *  
+ *  \param [in] osrs_p See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] osrs_t See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] osrs_h See Description 'BME280 OSRS Settings | 18' in .h File
+ *  \param [in] period_us Time between two Measurements, at least the typical Measurement Time
+ *  \param [in] normal True for 'Normal Mode' (StandBy Current between Measurements), False for 'Forced Mode' (Sleep Current)
+ *  \return Current in nA
+ *  
+ *  \details Charge of one Measurement per Period plus Idle Current for the Rest of the Period, see 'measure_charge_nC()'
+ */
+uint32_t BME280_I2C::average_current_nA(uint8_t osrs_p, uint8_t osrs_t, uint8_t osrs_h, uint32_t period_us, bool normal){
+	uint32_t t_meas = measure_time_us(osrs_p, osrs_t, osrs_h);
+	uint64_t q      = measure_charge_nC(osrs_p, osrs_t, osrs_h);
+	uint64_t idle   = normal ? (uint64_t)(BME280_IDD_SB * 1000) : (uint64_t)(BME280_IDD_SL * 1000);
+	if (period_us < t_meas){
+		period_us = t_meas;
+	}
+	return (uint32_t)( ( q * 1000000ULL + idle * (period_us - t_meas) ) / period_us );
+}
+
+/**
+ *  \brief Step Response of the IIR Filter
+ *  
+ *  \param [in] filter See Description 'BME280 FILTER Settings | 52' in .h File
+ *  \return Number of Samples until a Step reaches 75 %
+ *  
+ *  \details Table was taken from official BOSCH BME280 Datasheet | 14
+ */
+uint8_t BME280_I2C::filter_samples(uint8_t filter){
+	static const uint8_t samples[5] = { 1, 2, 5, 11, 22 };
+	return samples[(filter & 0b111) > 4 ? 4 : (filter & 0b111)];
+}
+
+/**
+ *  \brief Timing, Power and Bus Load of the active Configuration
+ *  
+ *  \param [out] b Budget, see 'BME280_BUDGET' in .h File
+ *  \param [in] interval_us Time between two 'forced()' Calls in 'Forced Mode', ignored in 'Normal Mode'. 0 = back to back
+ *  \param [in] single False for 'read_adc_burst()', True for 'read_adc_single()'
+ *  
+ *  \details Uses the Register Images and the last written Mode, so call after 'osrs_config()', 'filter_config()' and a Mode Change
+ *  \details Normal Mode: Period = typical Measurement Time + StandBy Time, see Datasheet | 9.2
+ *  \details Forced Mode: Period = 'interval_us', at least the maximum Measurement Time. The Trigger (2 Writes, 1 on Linux) counts to the Bus Load
+ *  \details Sleep Mode: no Samples, Sleep Current only
+ */
+void BME280_I2C::budget(BME280_BUDGET *b, uint32_t interval_us, bool single){
+	uint8_t osrs_t = _ctrl_meas >> 5;
+	uint8_t osrs_p = (_ctrl_meas >> 2) & 0b111;
+	uint8_t osrs_h = _ctrl_hum & 0b111;
+	uint8_t t_sb   = _config >> 5;
+	uint8_t filter = (_config >> 2) & 0b111;
+	bool    normal = (_mode == 0b11);
+
+	b->mode           = normal ? 0b11 : (_mode ? 0b01 : 0b00);
+	b->meas_typ_us    = measure_time_us(osrs_p, osrs_t, osrs_h);
+	b->meas_max_us    = measure_time_us(osrs_p, osrs_t, osrs_h, true);
+	b->filter_samples = filter_samples(filter);
+
+	if (b->mode == 0b00){
+		b->period_us        = 0;
+		b->odr_mHz          = 0;
+		b->current_nA       = (uint32_t)(BME280_IDD_SL * 1000);
+		b->i2c_bytes        = 0;
+		b->i2c_transactions = 0;
+		b->filter_step_us   = 0;
+		return;
+	}
+
+	if (normal){
+		b->period_us = b->meas_typ_us + standby_time_us(t_sb);
+	} else {
+		b->period_us = (interval_us > b->meas_max_us) ? interval_us : b->meas_max_us;
+	}
+	b->odr_mHz        = (uint32_t)(1000000000ULL / b->period_us);
+	b->current_nA     = average_current_nA(osrs_p, osrs_t, osrs_h, b->period_us, normal);
+	b->filter_step_us = (uint32_t)b->filter_samples * b->period_us;
+
+	/*
+	 * Burst: Register Address write (Address + 1) and 8 Bytes read (Address + 8)
+	 * Single: the same for 3 Bytes P, 3 Bytes T and 2 Bytes H
+	 * Forced: 'ctrl_hum' and 'ctrl_meas' written (Address + 2 each) before every Sample,
+	 *         on Linux as Register/Value Pairs in one Write (Address + 4)
+	 */
+	if (single){
+		b->i2c_bytes        = (2 + 4) + (2 + 4) + (2 + 3);
+		b->i2c_transactions = 6;
+	} else {
+		b->i2c_bytes        = 2 + 9;
+		b->i2c_transactions = 2;
+	}
+	if ( !normal ){
+#if BME280_LINUX
+		b->i2c_bytes        += 1 + 4;
+		b->i2c_transactions += 1;
+#else
+		b->i2c_bytes        += 2 * 3;
+		b->i2c_transactions += 2;
+#endif
+	}
+}
+#endif
@@ -11,8 +11,27 @@
  #ifndef __BME280_H__
 #define __BME280_H__
 
+/***********************************************************************
+ *  BME280 PLATFORM Settings
+ *  BME280_LINUX 0 = Arduino 'Wire', 1 = Linux '/dev/i2c-N' with I2C_RDWR
+ **********************************************************************/
+#ifndef BME280_LINUX
+#define BME280_LINUX					0
+#endif
+
+#if BME280_LINUX
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef int (*BME280_IOCTL)(int fd, unsigned long request, void *arg);
+#else
 #include "Arduino.h"
 #include <Wire.h>
+#endif
 
 /***********************************************************************
  *  BME280 default I2C Address
@@ -68,6 +87,101 @@
  **********************************************************************/
 #define BME280_FILTER					0b000
 
+/***********************************************************************
+ *  BME280 FEATURE Settings
+ *  Selects the compiled Precision Paths and Features. See Table.
+ *  32 Bit Integer Compensation is always compiled, 't_fine' needs it.
+ ***********************************************************************		 
+	define				|	functions
+	--------------------+--------------------------------------------------
+	BME280_USE_INT64	|	compensate_P_int64(), pressure_i64()
+	BME280_USE_DOUBLE	|	compensate_X_double(), X_dbl(), altitude_dbl()
+	BME280_USE_SINGLE	|	read_adc_single()
+	BME280_USE_DEADBAND	|	deadband_config(), read_adc_event(). Off by Default
+	BME280_USE_SINK		|	sink_attach(), 'BME280_Stats::begin()'. Off by Default
+	BME280_USE_LUT		|	compensate_T_lut(), compensate_H_lut(). Off by Default
+	BME280_USE_BUDGET	|	budget(), measure_time_us(), standby_time_us(), average_current_nA(), ...
+						|	Needed by 'BME280_Adaptive' and 'BME280_Coro'. Off by Default
+	The Settings change the Layout of 'BME280_I2C': set them here or as global Build Flags
+	('-DBME280_USE_LUT=1', 'build.extra_flags', 'build_flags'), never by '#define' in a Sketch.
+	A Sketch built with other Settings than BME280_I2C.cpp fails to link, see 'BME280 CONFIG CHECK'.
+ **********************************************************************/
+#ifndef BME280_USE_INT64
+#define BME280_USE_INT64				1
+#endif
+#ifndef BME280_USE_DOUBLE
+#define BME280_USE_DOUBLE				1
+#endif
+#ifndef BME280_USE_SINGLE
+#define BME280_USE_SINGLE				1
+#endif
+#ifndef BME280_USE_DEADBAND
+#define BME280_USE_DEADBAND				0
+#endif
+#ifndef BME280_USE_SINK
+#define BME280_USE_SINK					0
+#endif
+#ifndef BME280_USE_LUT
+#define BME280_USE_LUT					0
+#endif
+#ifndef BME280_USE_BUDGET
+#define BME280_USE_BUDGET				0
+#endif
+
+/***********************************************************************
+ *  BME280 LUT Settings
+ *  Per-Device Tables, built from the Calibration Data by 'begin()'.
+ *  't_fine' is linear between 2^T_BITS + 1 Nodes over adc_T 0 - 2^20,
+ *  the Humidity Factor between 2^H_BITS + 1 Nodes over t_fine -51.2 - 153.6 DegC.
+ *  temperature(), humidity(), sample() and the Read Path use the Tables. See Table.
+ ***********************************************************************		 
+	BITS	|	RAM T + H	|	max. Error T	|	max. Error H (dig_H3 = 0 / 64)
+	--------+---------------+---------------+--------------------------------
+	 4		|	136 Bytes	|	0.02 DegC	|	0.015 / 0.059 %rH
+	 5		|	264 Bytes	|	0.01 DegC	|	0.015 / 0.025 %rH
+	 6		|	520 Bytes	|	0.01 DegC	|	0.015 / 0.017 %rH
+	 7		|	1032 Bytes	|	0.01 DegC	|	0.015 / 0.016 %rH
+	Error against 'compensate_T_int32()' / 'compensate_H_int32()' from -40 to 85 DegC, Datasheet Calibration,
+	measured by 'extras/bench/BME280_Sweep' densely over t_fine, every Node and Segment Midpoint included
+	0.01 DegC is 1 LSB of the Output. The Interpolation needs two 32 Bit Multiplications per Table, no 64 Bit Arithmetic
+ **********************************************************************/
+#ifndef BME280_LUT_T_BITS
+#define BME280_LUT_T_BITS				5
+#endif
+#ifndef BME280_LUT_H_BITS
+#define BME280_LUT_H_BITS				5
+#endif
+#if BME280_LUT_T_BITS < 4 || BME280_LUT_T_BITS > 12 || BME280_LUT_H_BITS < 4 || BME280_LUT_H_BITS > 12
+#error "BME280_LUT_T_BITS and BME280_LUT_H_BITS must be 4 - 12"
+#endif
+#define BME280_LUT_H_BASE				(-262144L)	// t_fine of the first Node, -51.2 DegC
+#define BME280_LUT_H_SPAN_BITS			20			// t_fine Span of the Table, 2^20 = 204.8 DegC
+
+/***********************************************************************
+ *  BME280 CONFIG CHECK
+ *  Every Constructor calls 'bme280_config_<FEATURE Settings>_<LUT Bits>_<PLATFORM>()',
+ *  only BME280_I2C.cpp defines it, for its own Settings. A Sketch built with other
+ *  Settings stops at Link Time with "undefined reference to 'bme280_config_...'"
+ *  instead of running on a different Class Layout.
+ **********************************************************************/
+#define BME280_CONFIG_NAME_(i, d, s, db, sk, l, tb, hb, lx)	bme280_config_##i##d##s##db##sk##l##_##tb##_##hb##_##lx
+#define BME280_CONFIG_NAME(i, d, s, db, sk, l, tb, hb, lx)	BME280_CONFIG_NAME_(i, d, s, db, sk, l, tb, hb, lx)
+#define BME280_CONFIG_CHECK				BME280_CONFIG_NAME(	BME280_USE_INT64, BME280_USE_DOUBLE, BME280_USE_SINGLE,	\
+															BME280_USE_DEADBAND, BME280_USE_SINK, BME280_USE_LUT,	\
+															BME280_LUT_T_BITS, BME280_LUT_H_BITS, BME280_LINUX	)
+
+extern "C" void BME280_CONFIG_CHECK(void);
+
+/***********************************************************************
+ *  BME280 CURRENT CONSUMPTION
+ *  Typical supply current in uA during measurement. See Datasheet | 3.
+ **********************************************************************/
+#define BME280_IDD_T					350
+#define BME280_IDD_P					714
+#define BME280_IDD_H					340
+#define BME280_IDD_SB					0.2
+#define BME280_IDD_SL					0.1
+
 /***********************************************************************
  *  BME280 REGISTERS
  **********************************************************************/
@@ -110,6 +224,7 @@ enum{
 
 /***********************************************************************
  *  BME280 CALIBRATION DATA
+ *  16 Bit Values first, then 8 Bit Values: no Padding between Members
  **********************************************************************/
 typedef struct{
 	uint16_t dig_T1;
@@ -126,24 +241,64 @@ typedef struct{
 	int16_t  dig_P8;
 	int16_t  dig_P9;
 
-	uint8_t  dig_H1;
 	int16_t  dig_H2;
-	uint8_t  dig_H3;
 	int16_t  dig_H4;
 	int16_t  dig_H5;
+	uint8_t  dig_H1;
+	uint8_t  dig_H3;
 	int8_t   dig_H6;
 } BME280_CALIB_DATA;
 
+/***********************************************************************
+ *  BME280 COMPENSATED SAMPLE
+ **********************************************************************/
+typedef struct{
+	int32_t  temperature;	// DegC, resolution is 0.01 DegC. Value of "5123" equals 51.23 DegC
+	uint32_t pressure;		// Pa. Value of "96386" equals 963.86 hPa
+	uint32_t humidity;		// %RH in Q22.10 format. Value of "47445" equals 47445/1024 = 46.333 %RH
+} BME280_SAMPLE;
+
+/***********************************************************************
+ *  BME280 SAMPLE SINK
+ *  Called with every compensated Sample of the Read Path. See 'sink_attach()'.
+ **********************************************************************/
+typedef void (*BME280_SINK)(void *ctx, const BME280_SAMPLE *s);
+
+#if BME280_USE_BUDGET
+/***********************************************************************
+ *  BME280 BUDGET
+ *  Timing, Power and Bus Load of the active Configuration. See 'budget()'.
+ **********************************************************************/
+typedef struct{
+	uint8_t  mode;				// 0b00 Sleep, 0b01 Forced, 0b11 Normal
+	uint32_t meas_typ_us;		// typical Measurement Time
+	uint32_t meas_max_us;		// maximum Measurement Time
+	uint32_t period_us;			// Time between two Samples, 0 in Sleep Mode
+	uint32_t odr_mHz;			// Output Data Rate in mHz. Value of "1984" equals 1.984 Hz
+	uint32_t current_nA;		// average Supply Current of the Sensor
+	uint16_t i2c_bytes;			// I2C Bytes per Sample, Address Bytes included
+	uint8_t  i2c_transactions;	// I2C Transactions per Sample, a repeated Start counts as new Transaction
+	uint8_t  filter_samples;	// Samples until a Step reaches 75 % behind the IIR Filter
+	uint32_t filter_step_us;	// Time until a Step reaches 75 % behind the IIR Filter
+} BME280_BUDGET;
+#endif
+
 /***********************************************************************
  *  BME280_I2C CLASS
  **********************************************************************/
 class BME280_I2C{	
 	public:
 
-		BME280_I2C(void);
+		BME280_I2C(void){ BME280_CONFIG_CHECK(); }
 
 		bool     begin( uint8_t addr = BME280_ADDRESS );
 		
+#if BME280_LINUX
+		bool     bus_open( const char *device, BME280_IOCTL ioctl_fn = NULL );
+		void     bus_attach( int fd, BME280_IOCTL ioctl_fn );
+		void     bus_close(void);
+#endif
+		
 		int8_t   state( void );
 	
 		void 	 sleep(void);
@@ -159,70 +314,148 @@ class BME280_I2C{
 								uint8_t osrs_h = BME280_OSRS_H	);
 		void 	 osrs_mode_write(uint8_t mode);
 		
-		void 	 read_adc_burst(void);
-		void 	 read_adc_single(void);
+		bool 	 read_adc_burst(void);
+#if BME280_USE_SINGLE
+		bool 	 read_adc_single(void);
+#endif
+		
+#if BME280_USE_DEADBAND
+		void 	 deadband_config(	float T = 0.0f,
+									float P = 0.0f,
+									float H = 0.0f	);
+		bool 	 read_adc_event(void);
+#endif
+		
+#if BME280_USE_SINK
+		void 	 sink_attach( BME280_SINK fn, void *ctx = NULL );
+#endif
+		
+		int32_t  raw_P(void);
+		int32_t  raw_T(void);
+		int32_t  raw_H(void);
 		
 		uint32_t compensate_P_int32(int32_t adc_P);
+#if BME280_USE_INT64
 		uint32_t compensate_P_int64(int32_t adc_P);
-		double   compensate_P_double(int32_t adc_P);
-		
+#endif
 		int32_t  compensate_T_int32(int32_t adc_T);
-		double   compensate_T_double(int32_t adc_T);
-		
 		uint32_t compensate_H_int32(int32_t adc_H);
+#if BME280_USE_LUT
+		int32_t  compensate_T_lut(int32_t adc_T);
+		uint32_t compensate_H_lut(int32_t adc_H);
+#endif
+#if BME280_USE_DOUBLE
+		double   compensate_P_double(int32_t adc_P);
+		double   compensate_T_double(int32_t adc_T);
 		double   compensate_H_double(int32_t adc_H);
+#endif
 		
 		int32_t  pressure(void);
+		int32_t  temperature(void);
+		int32_t  humidity(void);
+#if BME280_USE_INT64
 		int32_t  pressure_i64(void);
+#endif
+#if BME280_USE_DOUBLE
 		double   pressure_dbl(void);
-		
-		int32_t  temperature(void);
 		double   temperature_dbl(void);
-		
-		int32_t  humidity(void);
 		double 	 humidity_dbl(void);
 		
 		double 	 altitude_dbl(double seaLevel);
+#endif
+		
+		void 	 sample(BME280_SAMPLE *s);
+		
+#if BME280_USE_BUDGET
+		void 	 budget(	BME280_BUDGET *b,
+							uint32_t interval_us = 0,
+							bool     single      = false	);
+		
+		static uint32_t measure_time_us(	uint8_t osrs_p,
+											uint8_t osrs_t,
+											uint8_t osrs_h,
+											bool    max = false	);
+		static uint32_t measure_charge_nC(	uint8_t osrs_p,
+											uint8_t osrs_t,
+											uint8_t osrs_h	);
+		static uint32_t standby_time_us(uint8_t t_sb);
+		static uint32_t average_current_nA(	uint8_t  osrs_p,
+											uint8_t  osrs_t,
+											uint8_t  osrs_h,
+											uint32_t period_us,
+											bool     normal	);
+		static uint8_t  filter_samples(uint8_t filter);
+#endif
 
 	private:
 		void 	  read_coeff(void);
 		bool      read_chip_id( uint8_t address );
 		
-		void 	  read_data_burst(void);		
+		bool 	  read_data_burst(void);		
+		
+#if BME280_USE_SINGLE
+		bool 	  read_adc_P( int32_t *adc );
+		bool 	  read_adc_T( int32_t *adc );
+		bool 	  read_adc_H( int32_t *adc );
+#endif
+		
+#if BME280_USE_DEADBAND
+		bool 	  adc_changed(void);
+#endif
+		
+		void 	  read_done(void);
 		
-		void 	  read_adc_P(void);
-		void 	  read_adc_T(void);
-		void 	  read_adc_H(void);
+#if BME280_USE_LUT
+		void 	  lut_build(void);
+		static int32_t lut_lerp(const int32_t *lut, uint32_t pos, uint8_t shift);
+		int64_t   lut_t_fine(int32_t adc_T);
+		int64_t   lut_h_factor(int32_t t_fine);
+#endif
 
-		uint8_t   readU8(byte reg);			// Unsigned
-		int8_t    readS8(byte reg);			// Signed
+		bool      read_regs(byte reg, uint8_t *buf, uint8_t len);
 		void      writeU8(byte reg, byte value);
+#if BME280_LINUX
+		void      write_pairs(uint8_t *d, uint8_t len);
+#endif
 		
-		uint16_t  readU16(byte reg);		// Unsigned
-		int16_t   readS16(byte reg);		// Signed
-		uint16_t  readU16_LE(byte reg); 	// little endian
-		int16_t   readS16_LE(byte reg); 	// little endian
-		
-		uint32_t  readU24(byte reg);		// Unsigned
-		int32_t   readS24(byte reg);		// Signed
-		uint32_t  readU24_LE(byte reg); 	// little endian
-		int32_t   readS24_LE(byte reg); 	// little endian
+		uint8_t   readU8(byte reg);			// Unsigned
 
 		bool	  _inited 			= false;
 		uint8_t   _i2caddr			= 0x00;
-		int32_t   _sensorID			= 0x00000000;
+#if BME280_LINUX
+		int       _fd				= -1;
+		bool      _fd_owned			= false;
+		BME280_IOCTL _ioctl			= NULL;
+#endif
 		
 		int32_t  _adc_P				= 0x00000000;
 		int32_t  _adc_T				= 0x00000000;
 		int32_t  _adc_H				= 0x00000000;
 		int32_t   _t_fine			= 0x00000000;
 		
-		uint8_t  _osrs_p			= 0x00;
-		uint8_t  _osrs_t			= 0x00;
-		uint8_t  _osrs_h			= 0x00;
+		uint8_t  _ctrl_hum			= 0x00;		// Register Image 'osrs_h'
+		uint8_t  _ctrl_meas			= 0x00;		// Register Image 'osrs_t', 'osrs_p', Mode excluded
+		uint8_t  _config			= 0x00;		// Register Image 't_sb', 'filter'
+		uint8_t  _mode				= 0x00;		// last written Mode
 		
-		uint8_t  _t_sb				= 0x00;
-		uint8_t  _filter			= 0x00;	
+#if BME280_USE_DEADBAND
+		int32_t  _db_P				= 0x00000000;
+		int32_t  _db_T				= 0x00000000;
+		int32_t  _db_H				= 0x00000000;
+		int32_t  _ref_adc_P			= 0x00000000;
+		int32_t  _ref_adc_T			= 0x00000000;
+		int32_t  _ref_adc_H			= 0x00000000;
+#endif
+
+#if BME280_USE_SINK
+		BME280_SINK _sink			= NULL;
+		void     *_sink_ctx			= NULL;
+#endif
+
+#if BME280_USE_LUT
+		int32_t  _lut_T[(1 << BME280_LUT_T_BITS) + 1];	// t_fine at adc_T = i << (20 - T_BITS)
+		int32_t  _lut_H[(1 << BME280_LUT_H_BITS) + 1];	// Humidity Factor at t_fine = BASE + (i << (SPAN_BITS - H_BITS))
+#endif
 
 		BME280_CALIB_DATA _bme280_calib;
 };
@@ -0,0 +1,227 @@
+/**
+ *  \file BME280_Stats.cpp
+ *  \brief BOSCH BME280 Sensor Library. Streaming Window Statistics.
+ *
+ *  \details Library C Code File
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include "BME280_Stats.h"
+
+BME280_Stats::BME280_Stats(){
+	clear();
+}
+
+/**
+ *  \brief Attach to the Read Path of a Sensor
+ *
+ *  \param [in] sensor Inited BME280 Sensor Node, NULL detaches
+ *
+ *  \details Every compensated Sample of 'read_adc_burst()', 'read_adc_single()' and accepted 'read_adc_event()' is added
+ *  \details Without 'BME280_USE_SINK' call 'add()' after each Reading instead
+ */
+void BME280_Stats::begin(BME280_I2C *sensor){
+#if BME280_USE_SINK
+	if (sensor){
+		sensor->sink_attach(sink, this);
+	}
+#else
+	(void)sensor;
+#endif
+}
+
+/**
+ *  \brief Set Window
+ *
+ *  \param [in] pane_samples Samples per Pane, the Hop between two Summaries. At least 1
+ *  \param [in] panes Panes per Window. 1 = tumbling Window, up to 'BME280_STATS_PANES' = sliding Window
+ *
+ *  \details A Window of 60 s at 1 Hz: 'window_config(60)' tumbling, 'window_config(15, 4)' sliding every 15 s
+ *  \details Clears all Statistics
+ */
+void BME280_Stats::window_config(uint16_t pane_samples, uint8_t panes){
+	_pane_samples = pane_samples ? pane_samples : 1;
+	_panes_used   = panes ? (panes > BME280_STATS_PANES ? BME280_STATS_PANES : panes) : 1;
+	clear();
+}
+
+/**
+ *  \brief Drop all Samples
+ */
+void BME280_Stats::clear(void){
+	_cur.count = 0;
+	for (uint8_t c = 0 ; c < 3 ; c++){
+		acc_clear(&_cur.ch[c]);
+	}
+	_head   = 0;
+	_filled = 0;
+	_fresh  = false;
+}
+
+/**
+ *  \brief Add one Sample
+ *
+ *  \param [in] s Compensated Sample
+ *  \return True if a Window was completed by this Sample, read it with 'summary()'
+ *
+ *  \details Constant Time: the Sample goes into the current Pane, a full Pane is moved into the Ring
+ */
+bool BME280_Stats::add(const BME280_SAMPLE *s){
+	_cur.count++;
+	acc_add(&_cur.ch[BME280_STATS_T], _cur.count, s->temperature);
+	acc_add(&_cur.ch[BME280_STATS_P], _cur.count, (int32_t)s->pressure);
+	acc_add(&_cur.ch[BME280_STATS_H], _cur.count, (int32_t)s->humidity);
+
+	if (_cur.count < _pane_samples){
+		return false;
+	}
+
+	_panes[_head] = _cur;
+	_head = (_head + 1) % _panes_used;
+	if (_filled < _panes_used){
+		_filled++;
+	}
+	_cur.count = 0;
+	for (uint8_t c = 0 ; c < 3 ; c++){
+		acc_clear(&_cur.ch[c]);
+	}
+	_fresh = (_filled == _panes_used);
+	return _fresh;
+}
+
+/**
+ *  \brief New Window complete
+ *
+ *  \return True if a Window was completed since the last 'summary()'
+ */
+bool BME280_Stats::ready(void){
+	return _fresh;
+}
+
+/**
+ *  \brief Statistics of the last Window
+ *
+ *  \param [out] out Count, Min, Max, Mean and Standard Deviation per Channel
+ *
+ *  \details Merges the completed Panes with Chan's parallel Algorithm. Before the first Window is complete,
+ *  \details the completed Panes and the current Pane are reported, so 'count' tells how much Data is behind it
+ */
+void BME280_Stats::summary(BME280_SUMMARY *out){
+	BME280_STATS_ACC acc[3];
+	uint32_t n = 0;
+
+	for (uint8_t c = 0 ; c < 3 ; c++){
+		acc_clear(&acc[c]);
+	}
+	for (uint8_t i = 0 ; i < _filled ; i++){
+		for (uint8_t c = 0 ; c < 3 ; c++){
+			acc_merge(&acc[c], n, &_panes[i].ch[c], _panes[i].count);
+		}
+		n += _panes[i].count;
+	}
+	if (_filled < _panes_used){
+		for (uint8_t c = 0 ; c < 3 ; c++){
+			acc_merge(&acc[c], n, &_cur.ch[c], _cur.count);
+		}
+		n += _cur.count;
+	}
+
+	_fresh     = false;
+	out->count = n;
+	acc_result(&out->T, &acc[BME280_STATS_T], n);
+	acc_result(&out->P, &acc[BME280_STATS_P], n);
+	acc_result(&out->H, &acc[BME280_STATS_H], n);
+}
+
+/**
+ *  \brief 'BME280_SINK' for 'BME280_I2C::sink_attach()'
+ *
+ *  \param [in] ctx 'BME280_Stats' Instance
+ *  \param [in] s Compensated Sample
+ */
+void BME280_Stats::sink(void *ctx, const BME280_SAMPLE *s){
+	((BME280_Stats *)ctx)->add(s);
+}
+
+/**
+ *  \brief Empty Accumulator
+ */
+void BME280_Stats::acc_clear(BME280_STATS_ACC *a){
+	a->min = INT32_MAX;
+	a->max = INT32_MIN;
+	a->sum = 0;
+	a->m2  = 0.0f;
+}
+
+/**
+ *  \brief Welford Update
+ *
+ *  \param [in] a Accumulator
+ *  \param [in] n Count including 'x'
+ *  \param [in] x new Value
+ *
+ *  \details M2 += (x - mean_old) * (x - mean_new). Both Deviations come from the exact Sum as (x * n - sum) / n,
+ *  \details so the float Part never holds a large Mean and keeps its Precision for small Deviations
+ */
+void BME280_Stats::acc_add(BME280_STATS_ACC *a, uint16_t n, int32_t x){
+	float d_old = (n > 1) ? (float)((int64_t)x * (n - 1) - a->sum) / (float)(n - 1) : 0.0f;
+	a->sum += x;
+	float d_new = (float)((int64_t)x * n - a->sum) / (float)n;
+	a->m2 += d_old * d_new;
+	if (x < a->min){
+		a->min = x;
+	}
+	if (x > a->max){
+		a->max = x;
+	}
+}
+
+/**
+ *  \brief Chan Merge of two Accumulators
+ *
+ *  \param [in,out] a Accumulator with 'na' Values, receives the Result
+ *  \param [in] na Count of 'a'
+ *  \param [in] b Accumulator with 'nb' Values
+ *  \param [in] nb Count of 'b'
+ *
+ *  \details M2 = M2_a + M2_b + delta^2 * na * nb / n with delta = mean_b - mean_a = (sum_b * na - sum_a * nb) / (na * nb)
+ */
+void BME280_Stats::acc_merge(BME280_STATS_ACC *a, uint32_t na, const BME280_STATS_ACC *b, uint32_t nb){
+	if (nb == 0){
+		return;
+	}
+	if (na){
+		float num = (float)(b->sum * (int64_t)na - a->sum * (int64_t)nb);
+		a->m2 += b->m2 + num * num / ((float)na * (float)nb * (float)(na + nb));
+	} else {
+		a->m2 = b->m2;
+	}
+	a->sum += b->sum;
+	if (b->min < a->min){
+		a->min = b->min;
+	}
+	if (b->max > a->max){
+		a->max = b->max;
+	}
+}
+
+/**
+ *  \brief Accumulator to Summary
+ *
+ *  \param [out] out Min, Max, Mean, Standard Deviation
+ *  \param [in] a Accumulator
+ *  \param [in] n Count
+ */
+void BME280_Stats::acc_result(BME280_STATS_CHANNEL *out, const BME280_STATS_ACC *a, uint32_t n){
+	if (n == 0){
+		out->min = out->max = out->mean = 0;
+		out->stddev = 0.0f;
+		return;
+	}
+	out->min    = a->min;
+	out->max    = a->max;
+	out->mean   = (int32_t)((a->sum >= 0 ? a->sum + (int64_t)(n / 2) : a->sum - (int64_t)(n / 2)) / (int64_t)n);
+	out->stddev = (n > 1) ? sqrtf(a->m2 / (float)(n - 1)) : 0.0f;
+}
@@ -0,0 +1,106 @@
+/**
+ *  \file BME280_Stats.h
+ *  \brief BOSCH BME280 Sensor Library. Streaming Window Statistics.
+ *
+ *  \details Library Definition File
+ *  \details Min, Max, Mean and Standard Deviation of Temperature, Pressure and Humidity over tumbling or sliding Windows
+ *  \details Constant Time per Sample and constant Memory, no Sample is stored
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_STATS_H__
+#define __BME280_STATS_H__
+
+#include "BME280_I2C.h"
+
+/***********************************************************************
+ *  BME280 STATS Settings
+ *  BME280_STATS_PANES  Maximum Number of Panes of a sliding Window, RAM is 62 Bytes per Pane on AVR
+ ***********************************************************************
+	window		|	panes	|	summary
+	------------+-----------+------------------------------------------
+	 tumbling	|	1		|	every 'pane_samples', then restart
+	 sliding	|	>1		|	every 'pane_samples' over the last 'panes * pane_samples'
+ **********************************************************************/
+#ifndef BME280_STATS_PANES
+#define BME280_STATS_PANES				4
+#endif
+
+enum{
+	BME280_STATS_T						= 0,
+	BME280_STATS_P						= 1,
+	BME280_STATS_H						= 2,
+};
+
+/***********************************************************************
+ *  BME280 STATS Accumulator of one Channel
+ *  Exact Sum in 64 Bit fixed point, Welford's M2 in float
+ **********************************************************************/
+typedef struct{
+	int32_t  min;
+	int32_t  max;
+	int64_t  sum;
+	float	 m2;				// Sum of squared Deviations from the Mean
+} BME280_STATS_ACC;
+
+typedef struct{
+	uint16_t count;
+	BME280_STATS_ACC ch[3];		// BME280_STATS_T, BME280_STATS_P, BME280_STATS_H
+} BME280_STATS_PANE;
+
+/***********************************************************************
+ *  BME280 STATS Summary of one Window
+ *  Units of 'BME280_SAMPLE': T in 0.01 DegC, P in Pa, H in %RH Q22.10
+ **********************************************************************/
+typedef struct{
+	int32_t  min;
+	int32_t  max;
+	int32_t  mean;				// rounded
+	float	 stddev;			// Sample Standard Deviation, 0 for less than 2 Samples
+} BME280_STATS_CHANNEL;
+
+typedef struct{
+	uint32_t count;
+	BME280_STATS_CHANNEL T;
+	BME280_STATS_CHANNEL P;
+	BME280_STATS_CHANNEL H;
+} BME280_SUMMARY;
+
+/***********************************************************************
+ *  BME280_STATS CLASS
+ **********************************************************************/
+class BME280_Stats{
+	public:
+
+		BME280_Stats(void);
+
+		void	 begin( BME280_I2C *sensor );
+		void	 window_config(	uint16_t pane_samples = 60,
+								uint8_t  panes        = 1	);
+		void	 clear(void);
+
+		bool	 add( const BME280_SAMPLE *s );
+		bool	 ready(void);
+		void	 summary( BME280_SUMMARY *out );
+
+		static void sink( void *ctx, const BME280_SAMPLE *s );
+
+	private:
+		static void acc_clear( BME280_STATS_ACC *a );
+		static void acc_add( BME280_STATS_ACC *a, uint16_t n, int32_t x );
+		static void acc_merge( BME280_STATS_ACC *a, uint32_t na, const BME280_STATS_ACC *b, uint32_t nb );
+		static void acc_result( BME280_STATS_CHANNEL *out, const BME280_STATS_ACC *a, uint32_t n );
+
+		BME280_STATS_PANE _cur;
+		BME280_STATS_PANE _panes[BME280_STATS_PANES];
+
+		uint16_t _pane_samples		= 60;
+		uint8_t  _panes_used		= 1;
+		uint8_t  _head				= 0;		// next Pane to overwrite
+		uint8_t  _filled			= 0;		// completed Panes in the Ring
+		bool	 _fresh				= false;	// Window completed, not yet read
+};
+
+#endif
@@ -3,6 +3,7 @@
  */
 #include <Wire.h>
 #include <BME280_I2C.h>
+#include <BME280_Format.h>
 
 /*
  * Defines
@@ -12,9 +13,11 @@
 #define GPIO_I2C_SCL 5
 
 /*
- * Create BME280 Sensor Node
+ * Create BME280 Sensor Node and an Output Buffer, every Line is formatted into 'buf', nothing is allocated
  */
 BME280_I2C BME280;
+char buf[96];
+BME280_Format out(buf, sizeof(buf));
 
 /*
  * Setup Routine
@@ -35,14 +38,14 @@ void setup() {
   Serial.println("PROG >> DATE >> " __DATE__ );
   Serial.println("PROG >> TIME >> " __TIME__ );
   Serial.println("PROG >> GCC  >> " __VERSION__ );
-  Serial.println(String("PROG >> IDE  >> ") + IDEString() );
+  Serial.printf("PROG >> IDE  >> %u.%u.%u\r\n", ARDUINO / 10000, (ARDUINO % 10000) / 100, ARDUINO % 100);
   Serial.println("CHIP INFORMATION =========================================================");
   Serial.printf("CHIP >> CORE  >> ID: %08X\r\n", ESP.getChipId());
-  Serial.println(String("CHIP >> CORE  >> Free Heap: ") + ESP.getFreeHeap() / 1024 + " kB");
+  Serial.printf("CHIP >> CORE  >> Free Heap: %u kB\r\n", ESP.getFreeHeap() / 1024);
   Serial.println("CHIP >> CORE  >> Speed: 80 MHz");
   Serial.printf("CHIP >> FLASH >> ID : %08X\r\n", ESP.getFlashChipId());
-  Serial.println(String("CHIP >> FLASH >> Size: ") + ESP.getFlashChipRealSize() / 1024 + " kB");
-  Serial.println(String("CHIP >> FLASH >> Speed: ") + ESP.getFlashChipSpeed()/1000000 + " MHz");
+  Serial.printf("CHIP >> FLASH >> Size: %u kB\r\n", ESP.getFlashChipRealSize() / 1024);
+  Serial.printf("CHIP >> FLASH >> Speed: %u MHz\r\n", ESP.getFlashChipSpeed() / 1000000);
   Serial.println("==========================================================================");
   /* 
    * Open I2C Bus on defined Pins and give BME280 time to 'boot'
@@ -65,28 +68,40 @@ void setup() {
 }
 
 void loop() {
+  BME280_SAMPLE s;
+
   /*
    * Read Data in 'Burst Mode' from BME280
    * 
    * Preferred Method to read Data from BME280, because no Measurements will get mixed up
    */
   BME280.read_adc_burst();
+  BME280.sample(&s);
    
   /*
-   * Print compensated BME280 Data 
+   * Print compensated BME280 Data. Integer Values go through 'BME280_Format', 'double' Values straight to Serial,
+   * no 'String' is built, so the Heap does not fragment over Time
    */
-  Serial.println( String("BME280 >> TEMP  >> I32 >> ") + (int32_t) BME280.temperature()     + " C" );
-  Serial.println( String("BME280 >> TEMP  >> DBL >> ") + (double)  BME280.temperature_dbl() + " C" );
-  
-  Serial.println( String("BME280 >> PRESS >> I32 >> ") + (int32_t) BME280.pressure()        + " Pa" );
-  Serial.println( String("BME280 >> PRESS >> I64 >> ") + (int32_t) BME280.pressure_i64()    + " Pa" );
-  Serial.println( String("BME280 >> PRESS >> DBL >> ") + (double)  BME280.pressure_dbl()    + " Pa" );
-  
-  Serial.println( String("BME280 >> HUMID >> I32 >> ") + (int32_t) BME280.humidity()        + " %rH" );  
-  Serial.println( String("BME280 >> HUMID >> DBL >> ") + (double)  BME280.humidity_dbl()    + " %rH" );
-   
-  Serial.println( String("BME280 >> ALTIT >> DBL >> ") + (double)  BME280.altitude_dbl(1013.25) + " m" );
-  
+  print_i32("BME280 >> TEMP  >> I32 >> ", BME280.temperature(), " C");
+  print_dbl("BME280 >> TEMP  >> DBL >> ", BME280.temperature_dbl(), " C");
+
+  print_i32("BME280 >> PRESS >> I32 >> ", BME280.pressure(), " Pa");
+  print_i32("BME280 >> PRESS >> I64 >> ", BME280.pressure_i64(), " Pa");
+  print_dbl("BME280 >> PRESS >> DBL >> ", BME280.pressure_dbl(), " Pa");
+
+  print_i32("BME280 >> HUMID >> I32 >> ", BME280.humidity(), " %rH");
+  print_dbl("BME280 >> HUMID >> DBL >> ", BME280.humidity_dbl(), " %rH");
+
+  print_dbl("BME280 >> ALTIT >> DBL >> ", BME280.altitude_dbl(1013.25), " m");
+
+  /*
+   * The whole Sample as one JSON Record
+   */
+  out.clear();
+  out.text("BME280 >> JSON  >> ");
+  out.json(&s);
+  Serial.println(buf);
+
   Serial.println("==========================================================================");
   
   /*
@@ -95,15 +110,22 @@ void loop() {
   delay(1000);
 }
 
-String IDEString(){
-  uint16_t IDE = ARDUINO;
-  String tmp = "";
-  tmp += String(IDE/10000);
-  IDE %= 10000;
-  tmp += ".";
-  tmp += String(IDE/100);
-  IDE %= 100;
-  tmp += ".";
-  tmp += String(IDE);
-  return tmp;
+/*
+ * One Line with an Integer Value
+ */
+void print_i32(const char *label, int32_t value, const char *unit){
+  out.clear();
+  out.text(label);
+  out.decimal(value);
+  out.text(unit);
+  Serial.println(buf);
+}
+
+/*
+ * One Line with a 'double' Value, 2 Decimals
+ */
+void print_dbl(const char *label, double value, const char *unit){
+  Serial.print(label);
+  Serial.print(value, 2);
+  Serial.println(unit);
 }
@@ -0,0 +1,135 @@
+/*
+ * Includes
+ */
+#include <Wire.h>
+#include <BME280_I2C.h>
+#include <BME280_Derived.h>
+
+/*
+ * Defines
+ */
+#define BME280ADDR 0x76
+#define GPIO_I2C_SDA 4
+#define GPIO_I2C_SCL 5
+#define ALTITUDE 250.0
+#define LOOPS 1000
+
+/*
+ * Create BME280 Sensor Node and Derived Quantities
+ */
+BME280_I2C BME280;
+BME280_Derived Derived;
+
+/*
+ * Setup Routine
+ */
+void setup() {
+  /*
+   * Open Serial Port for Debug
+   */
+  Serial.begin(115200);
+  delay(250);
+  Serial.println("");
+  Serial.println("");
+  Serial.println("PROG INFORMATION =========================================================");
+  Serial.println("PROG >> INFO >> BOSCH BME280 Testprogram - Derived Quantities Benchmark");
+  Serial.println("==========================================================================");
+  /*
+   * Open I2C Bus on defined Pins and give BME280 time to 'boot'
+   */
+  Wire.begin(GPIO_I2C_SDA, GPIO_I2C_SCL);
+  Serial.println("I2C  >> Bus initialized!");
+  delay(1500);
+
+  /*
+   * Init BME280 on I2C
+   */
+  if (!BME280.begin(BME280ADDR)) {
+    Serial.println("I2C  >> No Sensor detected!");
+    Serial.println("==========================================================================");
+    while (1);
+  } else {
+    Serial.println("I2C  >> BME280 initialized!");
+    Serial.println("==========================================================================");
+  }
+
+  /*
+   * Station Altitude for Sea-Level Pressure, pow() is only called here
+   */
+  Derived.altitude_config(ALTITUDE);
+}
+
+void loop() {
+  BME280_DERIVED_DATA fast;
+  BME280_DERIVED_I32  fix;
+  BME280_DERIVED_DATA ref;
+  uint32_t t_fast, t_fix, t_ref;
+  volatile float   sink_f;
+  volatile int32_t sink_i;
+
+  BME280.forced();
+  delay(10);
+  BME280.read_adc_burst();
+
+  int32_t  T   = BME280.temperature();
+  uint32_t P   = BME280.pressure();
+  uint32_t H   = BME280.humidity();
+  double   Td  = BME280.temperature_dbl();
+  double   Pd  = BME280.pressure_dbl();
+  double   Hd  = BME280.humidity_dbl();
+
+  /*
+   * The Inputs change with every Iteration and every Result goes to a 'volatile',
+   * so the Compiler can neither hoist 'compute()' out of the Loop nor drop it
+   */
+
+  /*
+   * Fast single pass Path on the int32 Outputs
+   */
+  t_fast = micros();
+  for (uint16_t i = 0 ; i < LOOPS ; i++) {
+    Derived.compute(T + (i & 15), P + (i & 15), H + (i & 15), &fast);
+    sink_f = fast.dew_point + fast.abs_humidity + fast.heat_index + fast.sea_level;
+  }
+  t_fast = micros() - t_fast;
+
+  /*
+   * Fixed Point Path, no float
+   */
+  t_fix = micros();
+  for (uint16_t i = 0 ; i < LOOPS ; i++) {
+    Derived.compute_i32(T + (i & 15), P + (i & 15), H + (i & 15), &fix);
+    sink_i = fix.dew_point + fix.abs_humidity + fix.heat_index + fix.sea_level;
+  }
+  t_fix = micros() - t_fix;
+
+  /*
+   * Naive Reference Path with libm exp(), log() and pow() on every Sample
+   */
+  t_ref = micros();
+  for (uint16_t i = 0 ; i < LOOPS ; i++) {
+    Derived.compute_dbl(Td + (i & 15) * 0.01, Pd + (i & 15), Hd + (i & 15) / 1024.0, &ref);
+    sink_f = ref.dew_point + ref.abs_humidity + ref.heat_index + ref.sea_level;
+  }
+  t_ref = micros() - t_ref;
+  (void) sink_f;
+  (void) sink_i;
+
+  /*
+   * Results of the last Iteration, same Inputs on all Paths
+   */
+  Serial.print("BME280 >> DEWPT >> FAST >> "); Serial.print(fast.dew_point, 3);    Serial.print(" C    FIX >> "); Serial.print(fix.dew_point / 100.0, 2);     Serial.print(" C    REF >> "); Serial.println(ref.dew_point, 3);
+  Serial.print("BME280 >> ABSHU >> FAST >> "); Serial.print(fast.abs_humidity, 3); Serial.print(" g/m3 FIX >> "); Serial.print(fix.abs_humidity / 100.0, 2);  Serial.print(" g/m3 REF >> "); Serial.println(ref.abs_humidity, 3);
+  Serial.print("BME280 >> HEATI >> FAST >> "); Serial.print(fast.heat_index, 3);   Serial.print(" C    FIX >> "); Serial.print(fix.heat_index / 100.0, 2);    Serial.print(" C    REF >> "); Serial.println(ref.heat_index, 3);
+  Serial.print("BME280 >> SLP   >> FAST >> "); Serial.print(fast.sea_level, 1);    Serial.print(" Pa   FIX >> "); Serial.print(fix.sea_level);                Serial.print(" Pa   REF >> "); Serial.println(ref.sea_level, 1);
+
+  Serial.print("BENCH  >> FAST  >> "); Serial.print((float)t_fast / LOOPS, 2); Serial.println(" us/sample");
+  Serial.print("BENCH  >> FIX   >> "); Serial.print((float)t_fix  / LOOPS, 2); Serial.println(" us/sample");
+  Serial.print("BENCH  >> REF   >> "); Serial.print((float)t_ref  / LOOPS, 2); Serial.println(" us/sample");
+  Serial.println("==========================================================================");
+
+  /*
+   * Pause for next reading
+   */
+  delay(1000);
+}
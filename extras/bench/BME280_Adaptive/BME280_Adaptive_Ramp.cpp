@@ -0,0 +1,101 @@
+/**
+ *  \file BME280_Adaptive_Ramp.cpp
+ *  \brief BOSCH BME280 Sensor Library. Ramp Check of 'BME280_Adaptive'.
+ *
+ *  \details Linux Harness. Drives the simulated BME280 with Temperature Ramps of rising Slope in simulated Time.
+ *  \details Every Sample is taken one Period of the active Profile after the last one and passes the IIR Filter
+ *  \details of the active Profile, reset on every Switch like on the Sensor.
+ *  \details Per Slope: Profile after Settling, Switches in total and after Settling.
+ *  \details Fails (Exit 1) if any Ramp switches after Settling or a steeper Ramp settles on a less responsive Profile.
+ *  \details
+ *  \details Build:  g++ -O2 -std=c++17 -DBME280_USE_BUDGET=1 -I../../host -I../../.. BME280_Adaptive_Ramp.cpp ../../../BME280_Adaptive.cpp ../../../BME280_I2C.cpp -o BME280_Adaptive_Ramp
+ *  \details Run:    ./BME280_Adaptive_Ramp [max slope in counts/s]
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include <stdio.h>
+#include "Arduino.h"
+#include <Wire.h>
+#include "BME280_I2C.h"
+#include "BME280_Adaptive.h"
+#include "BME280_Fake.h"
+
+#define RAMP_SECONDS					900
+#define RAMP_SETTLE_SECONDS				300
+#define RAMP_START						300000
+#define RAMP_NOISE						2			// +- raw Counts before the Filter
+
+/***********************************************************************
+ *  IIR Coefficient of the default Profiles, see Table in BME280_Adaptive.h
+ **********************************************************************/
+static const uint8_t coefficient[BME280_ADAPTIVE_PROFILES] = { 4, 2, 1 };
+
+typedef struct{
+	uint8_t  settled;
+	uint32_t switches;
+	uint32_t late;
+} RAMP_RESULT;
+
+/**
+ *  \brief Run one Ramp
+ *
+ *  \param [in] slope Temperature Slope in raw Counts per Second
+ */
+static RAMP_RESULT ramp(double slope){
+	BME280_CALIB_DATA calib = BME280_FAKE_CALIB_DATASHEET;
+	BME280_Fake     fake;
+	BME280_I2C      sensor;
+	BME280_Adaptive adaptive;
+	RAMP_RESULT     r = { 0, 0, 0 };
+	uint32_t        lcg = 12345;
+	uint8_t         active;
+	double          t = 0.0, y = RAMP_START;
+
+	fake.calib(&calib);
+	Wire.attach(BME280_ADDRESS, fake.regs);
+	sensor.begin(BME280_ADDRESS);
+	adaptive.begin(&sensor);
+	active = adaptive.profile();
+
+	while (t < RAMP_SECONDS){
+		double x;
+
+		t  += 1.0e3 / adaptive.rate_mHz();
+		lcg = lcg * 1103515245UL + 12345;
+		x   = RAMP_START + slope * t + (int32_t)((lcg >> 16) % (2 * RAMP_NOISE + 1)) - RAMP_NOISE;
+		y  += (x - y) / coefficient[active];
+
+		fake.adc(415148, (int32_t)(y + 0.5), 0x6000);
+		sensor.read_adc_burst();
+		if (adaptive.update()){
+			r.switches++;
+			if (t > RAMP_SETTLE_SECONDS){
+				r.late++;
+			}
+			active = adaptive.profile();
+			y      = x;
+		}
+	}
+	r.settled = adaptive.profile();
+	return r;
+}
+
+int main(int argc, char **argv){
+	static const char *names[BME280_ADAPTIVE_PROFILES] = { "STABLE", "MODERATE", "DYNAMIC" };
+	double   max  = (argc > 1) ? strtod(argv[1], NULL) : 200.0;
+	uint8_t  last = BME280_PROFILE_STABLE;
+	uint32_t failed = 0;
+
+	printf("slope_counts_per_s,settled,switches,switches_after_settle\n");
+	for (double slope = 0.0 ; slope <= max ; slope += 0.5){
+		RAMP_RESULT r = ramp(slope);
+		bool bad = r.late || r.settled < last;
+		printf("%.1f,%s,%u,%u%s\n", slope, names[r.settled], r.switches, r.late, bad ? ",FAIL" : "");
+		failed += bad;
+		last = r.settled;
+	}
+	printf("%s: %u ramps failed\n", failed ? "FAIL" : "OK", failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+/**
+ *  \file BME280_Coro_Bench.cpp
+ *  \brief BOSCH BME280 Sensor Library. Sensors serviced per Thread with 'BME280_Coro'.
+ *
+ *  \details Linux Harness. Up to 112 simulated BME280 on the Host Stand-In of 'Wire', one Address each,
+ *  \details every Sensor measures in its own Coroutine, all on one Thread.
+ *  \details realtime: 'BME280_Loop' sleeps the real Measurement Time. Wall Time stays at one Sensor's Time,
+ *  \details           'blocking_ms' is the Time of forced(), delay(), read_adc_burst() one Sensor after the other
+ *  \details virtual:  the Clock jumps to the next Timer, so only the CPU Cost of Scheduling, I2C Stand-In and Compensation is left.
+ *  \details           'sensors_1Hz' is the Number of Sensors one Thread could service at 1 Sample per Second
+ *  \details 'bus_us' is the Bus Time per Sample at 400 kHz from 'budget()', the real Limit of one I2C Bus
+ *  \details The last Line counts failed Readings and Coroutine Frames that missed the 'BME280_FramePool', both should be 0
+ *  \details
+ *  \details Build:  g++ -O2 -std=c++20 -DBME280_CORO_TIMERS=128 -DBME280_CORO_FRAMES=224 -DBME280_USE_BUDGET=1 -I../../host -I../../.. BME280_Coro_Bench.cpp ../../../BME280_I2C.cpp -o BME280_Coro_Bench
+ *  \details Run:    ./BME280_Coro_Bench [samples per sensor]
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "Arduino.h"
+#include <Wire.h>
+#include "BME280_I2C.h"
+#include "BME280_Coro.h"
+#include "BME280_Fake.h"
+
+#define BENCH_SENSORS					112			// 7 bit Addresses 0x08 - 0x77
+
+/***********************************************************************
+ *  Loop with virtual Clock
+ **********************************************************************/
+class VirtualLoop : public BME280_Loop{
+	public:
+		uint32_t now_us(void) override { return _now; }
+	protected:
+		void	 idle( uint32_t us ) override { _now += us; }
+	private:
+		uint32_t _now				= 0;
+};
+
+static BME280_Fake   fakes[BENCH_SENSORS];
+static BME280_I2C    sensors[BENCH_SENSORS];
+static int64_t       checksum = 0;
+static uint32_t      failed   = 0;
+
+static uint64_t clock_ns(clockid_t id){
+	struct timespec ts;
+	clock_gettime(id, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ *  \brief One Sensor: 'samples' Measurements back to back
+ */
+static BME280_Task<> sensor_task(BME280_Coro node, uint32_t samples){
+	for (uint32_t i = 0 ; i < samples ; i++){
+		BME280_READING r = co_await node.measure();
+		if ( !r.ok ){
+			failed++;
+			continue;
+		}
+		checksum += r.sample.temperature + r.sample.pressure + r.sample.humidity;
+	}
+}
+
+/**
+ *  \brief Run 'n' Sensors concurrently on 'loop'
+ *
+ *  \return CPU Time in ns
+ */
+static uint64_t run(BME280_Loop *loop, uint8_t n, uint32_t samples, uint64_t *wall_ns){
+	static BME280_Task<> tasks[BENCH_SENSORS];
+	uint64_t c0 = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+	uint64_t w0 = clock_ns(CLOCK_MONOTONIC);
+
+	for (uint8_t i = 0 ; i < n ; i++){
+		tasks[i] = sensor_task(BME280_Coro(&sensors[i], loop), samples);
+		tasks[i].start();
+	}
+	loop->run();
+	for (uint8_t i = 0 ; i < n ; i++){
+		if ( !tasks[i].done() ){
+			fprintf(stderr, "sensor %u not finished\n", i);
+		}
+		tasks[i] = BME280_Task<>();
+	}
+
+	*wall_ns = clock_ns(CLOCK_MONOTONIC) - w0;
+	return clock_ns(CLOCK_PROCESS_CPUTIME_ID) - c0;
+}
+
+int main(int argc, char **argv){
+	static const uint8_t counts[6] = { 1, 8, 16, 32, 64, BENCH_SENSORS };
+	uint32_t samples = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 20;
+	BME280_CALIB_DATA calib = BME280_FAKE_CALIB_DATASHEET;
+	BME280_BUDGET b;
+
+	for (uint8_t i = 0 ; i < BENCH_SENSORS ; i++){
+		fakes[i].calib(&calib);
+		fakes[i].adc(415148 + 37 * i, 519888 - 11 * i, 0x6000 + 53 * i);
+		Wire.attach(0x08 + i, fakes[i].regs);
+		if ( !sensors[i].begin(0x08 + i) ){
+			fprintf(stderr, "no sensor at 0x%02X\n", 0x08 + i);
+			return 1;
+		}
+	}
+	sensors[0].forced();
+	sensors[0].budget(&b);
+
+	printf("mode,sensors,samples,wall_ms,blocking_ms,cpu_ns_per_sample,samples_per_s,sensors_1Hz,bus_us\n");
+	for (uint8_t v = 0 ; v < 2 ; v++){
+		for (uint8_t k = 0 ; k < 6 ; k++){
+			BME280_Loop  real;
+			VirtualLoop  virt;
+			uint64_t     wall;
+			uint8_t      n      = counts[k];
+			uint32_t     rounds = v ? samples * 50 : samples;
+			uint64_t     cpu    = run(v ? (BME280_Loop *)&virt : &real, n, rounds, &wall);
+			uint64_t     total  = (uint64_t)n * rounds;
+			double       ns     = (double)cpu / total;
+
+			printf("%s,%u,%llu,%.1f,%.1f,%.0f,%.0f,%.0f,%u\n", v ? "virtual" : "realtime", n, (unsigned long long)total,
+				   wall / 1e6, (double)total * b.meas_max_us / 1e3, ns,
+				   total * 1e9 / wall, 1e9 / ns, b.i2c_bytes * 9 * 1000 / 400);
+		}
+	}
+	printf("# checksum %lld, t_max %u us, failed %u, heap frames %u\n", (long long)checksum, b.meas_max_us,
+		   failed, BME280_FramePool::heap_frames());
+	return (failed || BME280_FramePool::heap_frames()) ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ *  \file BME280_Format_Bench.cpp
+ *  \brief BOSCH BME280 Sensor Library. Throughput and Heap Usage of 'BME280_Format'.
+ *
+ *  \details Linux Harness. Formats simulated Samples in every Format and reports Bytes per Second
+ *  \details and Heap Allocations per Sample. malloc() is wrapped to count every Allocation of the Process.
+ *  \details
+ *  \details Build:  g++ -O2 -std=c++17 -I../../host -I../../.. BME280_Format_Bench.cpp ../../../BME280_I2C.cpp ../../../BME280_Format.cpp -o BME280_Format_Bench
+ *  \details Run:    ./BME280_Format_Bench [samples]
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "Arduino.h"
+#include <Wire.h>
+#include "BME280_I2C.h"
+#include "BME280_Format.h"
+#include "BME280_Fake.h"
+
+/***********************************************************************
+ *  Allocation Counter (glibc)
+ **********************************************************************/
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+
+static volatile uint64_t allocations = 0;
+
+extern "C" void *malloc(size_t size){
+	allocations++;
+	return __libc_malloc(size);
+}
+extern "C" void *calloc(size_t n, size_t size){
+	allocations++;
+	return __libc_calloc(n, size);
+}
+extern "C" void *realloc(void *p, size_t size){
+	allocations++;
+	return __libc_realloc(p, size);
+}
+
+static uint64_t now_ns(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv){
+	static const char *names[4] = { "plain", "csv", "json", "influx" };
+	uint32_t samples = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000000;
+	BME280_CALIB_DATA calib = BME280_FAKE_CALIB_DATASHEET;
+	BME280_I2C    sensor;
+	BME280_Fake   fake;
+	BME280_SAMPLE s[64];
+	char          buf[128];
+	BME280_Format out(buf, sizeof(buf));
+
+	fake.calib(&calib);
+	Wire.attach(BME280_ADDRESS, fake.regs);
+	if ( !sensor.begin(BME280_ADDRESS) ){
+		fprintf(stderr, "no sensor\n");
+		return 1;
+	}
+
+	/*
+	 * A Table of Samples around the Datasheet Example, so Formatting is measured and not Compensation
+	 */
+	for (uint8_t i = 0 ; i < 64 ; i++){
+		fake.adc(415148 + 97 * i - 3000, 519888 - 131 * i, 0x6000 + 211 * i);
+		sensor.read_adc_burst();
+		sensor.sample(&s[i]);
+	}
+
+	printf("format,samples,bytes,ns_per_sample,mbytes_per_s,allocs_per_sample\n");
+	for (uint8_t f = 0 ; f < 4 ; f++){
+		uint64_t bytes = 0;
+		uint64_t a0 = allocations;
+		uint64_t t0 = now_ns();
+		for (uint32_t i = 0 ; i < samples ; i++){
+			out.clear();
+			switch (f){
+				case 0: out.plain(&s[i & 63]); break;
+				case 1: out.csv(&s[i & 63]); break;
+				case 2: out.json(&s[i & 63]); break;
+				case 3: out.influx("bme280,node=bench", &s[i & 63]); break;
+			}
+			bytes += out.length();
+		}
+		uint64_t ns = now_ns() - t0;
+		uint64_t a  = allocations - a0;
+		printf("%s,%u,%llu,%.2f,%.2f,%.6f\n", names[f], samples, (unsigned long long)bytes,
+			   (double)ns / samples, (double)bytes * 1000.0 / (double)ns, (double)a / samples);
+	}
+
+	out.clear();
+	out.json(&s[0]);
+	printf("# %s\n", buf);
+	return 0;
+}
@@ -0,0 +1,438 @@
+/**
+ *  \file BME280_Replay.cpp
+ *  \brief BOSCH BME280 Sensor Library. Trace Replay of the full Acquisition Path.
+ *
+ *  \details Linux Harness. Loads Register Traces (Calibration Block and raw Data Sequence) into a simulated BME280
+ *  \details on the timed Host Stand-In of 'Wire' and runs every Operation over every Sample of the Trace.
+ *  \details Per Operation: Wall and CPU Time per Call of the fastest Pass, modelled Bus Time, Transactions and Bytes per Call and a Checksum of the Results.
+ *  \details Bus Time, Transactions, Bytes and Checksum are deterministic, a Change between two Runs is a Change of the Driver.
+ *  \details Wall and CPU Time are Host Timings, compare them between Runs on the same Machine with 'compare.sh'.
+ *  \details '--realtime': the Stand-In sleeps for the modelled Bus Time, Wall Time includes it, CPU Time only the Sleep Calls.
+ *  \details
+ *  \details Build:  g++ -O2 -std=c++17 -DBME280_USE_DEADBAND=1 -I../../host -I../../.. BME280_Replay.cpp ../../../BME280_I2C.cpp -o BME280_Replay
+ *  \details         add '-DBME280_USE_LUT=1' for the Table Path
+ *  \details Run:    ./BME280_Replay [--clock <hz>] [--repeat <n>] [--realtime] [--json] traces/\*.trace > run.csv
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Arduino.h"
+#include <Wire.h>
+#include "BME280_I2C.h"
+#include "BME280_Fake.h"
+
+#define REPLAY_SAMPLES					4096
+
+/***********************************************************************
+ *  Trace
+ **********************************************************************/
+typedef struct{
+	const char *name;
+	uint8_t  chip;
+	uint8_t  calib_88[26];
+	uint8_t  calib_e1[7];
+	uint8_t  data[REPLAY_SAMPLES][8];
+	uint32_t samples;
+} REPLAY_TRACE;
+
+static REPLAY_TRACE trace;
+
+static bool parse_hex(const char *s, uint8_t *out, uint8_t len){
+	for (uint8_t i = 0 ; i < len ; i++){
+		unsigned v;
+		if (sscanf(s + 2 * i, "%2x", &v) != 1){
+			return false;
+		}
+		out[i] = (uint8_t)v;
+	}
+	return strlen(s) == 2u * len;
+}
+
+/**
+ *  \brief Load a Trace File
+ *
+ *  \details Lines: 'chip <hex>', 'calib <26 Bytes hex> <7 Bytes hex>', 'data <8 Bytes hex>', '#' Comments
+ */
+static bool load_trace(const char *path){
+	char line[256], key[16], a[96], b[32];
+	unsigned chip;
+	FILE *f = fopen(path, "r");
+	bool  calib = false;
+
+	if (f == NULL){
+		perror(path);
+		return false;
+	}
+	trace.name    = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+	trace.chip    = 0x60;
+	trace.samples = 0;
+	while (fgets(line, sizeof(line), f)){
+		int n = sscanf(line, "%15s %95s %31s", key, a, b);
+		if (n < 1 || key[0] == '#'){
+			continue;
+		}
+		if (strcmp(key, "chip") == 0 && n >= 2 && sscanf(a, "%x", &chip) == 1){
+			trace.chip = (uint8_t)chip;
+		} else if (strcmp(key, "calib") == 0 && n == 3 && parse_hex(a, trace.calib_88, 26) && parse_hex(b, trace.calib_e1, 7)){
+			calib = true;
+		} else if (strcmp(key, "data") == 0 && n >= 2 && trace.samples < REPLAY_SAMPLES && parse_hex(a, trace.data[trace.samples], 8)){
+			trace.samples++;
+		} else {
+			fprintf(stderr, "%s: bad line: %s", path, line);
+			fclose(f);
+			return false;
+		}
+	}
+	fclose(f);
+	if ( !calib || !trace.samples ){
+		fprintf(stderr, "%s: needs 'calib' and at least one 'data' line\n", path);
+		return false;
+	}
+	return true;
+}
+
+/***********************************************************************
+ *  Measurement
+ **********************************************************************/
+typedef struct{
+	uint64_t wall;				// fastest Pass
+	uint64_t cpu;				// fastest Pass
+	uint64_t mark_wall;
+	uint64_t mark_cpu;
+	uint64_t bus;
+	uint64_t transactions;
+	uint64_t bytes;
+	uint64_t calls;
+	uint64_t checksum;			// first Pass only, independent of 'repeat'
+	uint32_t pass;
+} REPLAY_RESULT;
+
+static BME280_Fake fake;
+static uint32_t    repeat   = 20;
+static bool        json     = false;
+
+static uint64_t clock_ns(clockid_t id){
+	struct timespec ts;
+	clock_gettime(id, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ *  \brief Put Sample 'i' of the Trace into the Data Registers
+ */
+static inline void load_sample(uint32_t i){
+	memcpy(&fake.regs[BME280_REGISTER_PRESSUREDATA], trace.data[i], 8);
+}
+
+/**
+ *  \brief Fold one Result of the first Pass into the Checksum, FNV-1a on the Value
+ */
+static inline void fold(REPLAY_RESULT *r, int64_t v){
+	if (r->pass == 0){
+		r->checksum = (r->checksum ^ (uint64_t)v) * 0x100000001B3ULL;
+	}
+}
+
+static void start(REPLAY_RESULT *r){
+	memset(r, 0, sizeof(*r));
+	r->checksum = 0xCBF29CE484222325ULL;
+	r->wall = r->cpu = UINT64_MAX;
+	Wire.reset_counters();
+	r->mark_cpu  = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+	r->mark_wall = clock_ns(CLOCK_MONOTONIC);
+}
+
+/**
+ *  \brief End of one Pass over the Trace, keeps the fastest Pass
+ *
+ *  \details The Minimum of 'repeat' Passes is far less disturbed by other Load on the Host than the Mean
+ */
+static void lap(REPLAY_RESULT *r){
+	uint64_t cpu  = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+	uint64_t wall = clock_ns(CLOCK_MONOTONIC);
+	if (cpu - r->mark_cpu < r->cpu){
+		r->cpu = cpu - r->mark_cpu;
+	}
+	if (wall - r->mark_wall < r->wall){
+		r->wall = wall - r->mark_wall;
+	}
+	r->pass++;
+	r->mark_cpu  = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+	r->mark_wall = clock_ns(CLOCK_MONOTONIC);
+}
+
+/**
+ *  \brief Print one Operation
+ *
+ *  \details Times per Call of the fastest Pass, Bus Time, Transactions and Bytes per Call over all Passes
+ */
+static void stop(REPLAY_RESULT *r, const char *op, uint64_t calls){
+	r->bus          = Wire.bus_ns;
+	r->transactions = Wire.transactions;
+	r->bytes        = Wire.bytes;
+	r->calls        = calls;
+
+	double c = (double)calls;
+	double p = (double)calls / repeat;
+	if (json){
+		printf("{\"trace\":\"%s\",\"op\":\"%s\",\"calls\":%llu,\"wall_ns\":%.1f,\"cpu_ns\":%.1f,\"bus_ns\":%.1f,"
+			   "\"transactions\":%.2f,\"bytes\":%.2f,\"checksum\":\"%016llx\"}\n",
+			   trace.name, op, (unsigned long long)calls, r->wall / p, r->cpu / p, r->bus / c,
+			   r->transactions / c, r->bytes / c, (unsigned long long)r->checksum);
+	} else {
+		printf("%s,%s,%llu,%.1f,%.1f,%.1f,%.2f,%.2f,%016llx\n",
+			   trace.name, op, (unsigned long long)calls, r->wall / p, r->cpu / p, r->bus / c,
+			   r->transactions / c, r->bytes / c, (unsigned long long)r->checksum);
+	}
+}
+
+/***********************************************************************
+ *  Operations
+ **********************************************************************/
+static void replay(void){
+	static int32_t adc_P[REPLAY_SAMPLES], adc_T[REPLAY_SAMPLES], adc_H[REPLAY_SAMPLES];
+	BME280_I2C    sensor;
+	BME280_SAMPLE s;
+	REPLAY_RESULT r;
+	uint32_t      n = trace.samples;
+	uint64_t      calls = (uint64_t)repeat * n;
+
+	memset(fake.regs, 0, sizeof(fake.regs));
+	fake.regs[BME280_REGISTER_CHIPID] = trace.chip;
+	memcpy(&fake.regs[BME280_REGISTER_DIG_T1], trace.calib_88, 26);
+	memcpy(&fake.regs[BME280_REGISTER_DIG_H2], trace.calib_e1, 7);
+	load_sample(0);
+	Wire.attach(BME280_ADDRESS, fake.regs);
+
+	/*
+	 * begin(): Chip ID, Calibration, Configuration and first Trigger
+	 */
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		BME280_I2C fresh;
+		fold(&r, fresh.begin(BME280_ADDRESS));
+		lap(&r);
+	}
+	stop(&r, "begin", repeat);
+	if ( !sensor.begin(BME280_ADDRESS) ){
+		fprintf(stderr, "%s: chip id 0x%02X is no BME280\n", trace.name, trace.chip);
+		return;
+	}
+
+	/*
+	 * Bus Operations
+	 */
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			sensor.forced();
+		}
+		lap(&r);
+	}
+	stop(&r, "forced", calls);
+
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			load_sample(i);
+			sensor.read_adc_burst();
+			fold(&r, sensor.raw_P());
+			fold(&r, sensor.raw_T());
+			fold(&r, sensor.raw_H());
+		}
+		lap(&r);
+	}
+	stop(&r, "read_adc_burst", calls);
+
+#if BME280_USE_SINGLE
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			load_sample(i);
+			sensor.read_adc_single();
+			fold(&r, sensor.raw_P());
+			fold(&r, sensor.raw_T());
+			fold(&r, sensor.raw_H());
+		}
+		lap(&r);
+	}
+	stop(&r, "read_adc_single", calls);
+#endif
+
+#if BME280_USE_DEADBAND
+	load_sample(0);
+	sensor.read_adc_burst();
+	sensor.deadband_config(0.05f, 3.0f, 0.5f);
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			load_sample(i);
+			fold(&r, sensor.read_adc_event());
+		}
+		lap(&r);
+	}
+	stop(&r, "read_adc_event", calls);
+#endif
+
+	/*
+	 * Compensation only, on the raw Values of the Trace
+	 */
+	for (uint32_t i = 0 ; i < n ; i++){
+		load_sample(i);
+		sensor.read_adc_burst();
+		adc_P[i] = sensor.raw_P();
+		adc_T[i] = sensor.raw_T();
+		adc_H[i] = sensor.raw_H();
+	}
+
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			fold(&r, sensor.compensate_T_int32(adc_T[i]));
+			fold(&r, sensor.compensate_P_int32(adc_P[i]));
+			fold(&r, sensor.compensate_H_int32(adc_H[i]));
+		}
+		lap(&r);
+	}
+	stop(&r, "compensate_int32", calls);
+
+#if BME280_USE_INT64
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			fold(&r, sensor.compensate_T_int32(adc_T[i]));
+			fold(&r, sensor.compensate_P_int64(adc_P[i]));
+			fold(&r, sensor.compensate_H_int32(adc_H[i]));
+		}
+		lap(&r);
+	}
+	stop(&r, "compensate_int64", calls);
+#endif
+
+#if BME280_USE_DOUBLE
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			fold(&r, llround(sensor.compensate_T_double(adc_T[i]) * 1000.0));
+			fold(&r, llround(sensor.compensate_P_double(adc_P[i]) * 1000.0));
+			fold(&r, llround(sensor.compensate_H_double(adc_H[i]) * 1000.0));
+		}
+		lap(&r);
+	}
+	stop(&r, "compensate_double", calls);
+#endif
+
+#if BME280_USE_LUT
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			fold(&r, sensor.compensate_T_lut(adc_T[i]));
+			fold(&r, sensor.compensate_P_int32(adc_P[i]));
+			fold(&r, sensor.compensate_H_lut(adc_H[i]));
+		}
+		lap(&r);
+	}
+	stop(&r, "compensate_lut", calls);
+#endif
+
+	/*
+	 * Full Acquisition: Trigger, Read, Compensate
+	 */
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			load_sample(i);
+			sensor.forced();
+			sensor.read_adc_burst();
+			sensor.sample(&s);
+			fold(&r, s.temperature);
+			fold(&r, s.pressure);
+			fold(&r, s.humidity);
+		}
+		lap(&r);
+	}
+	stop(&r, "acquire_burst_int32", calls);
+
+#if BME280_USE_SINGLE
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			load_sample(i);
+			sensor.forced();
+			sensor.read_adc_single();
+			sensor.sample(&s);
+			fold(&r, s.temperature);
+			fold(&r, s.pressure);
+			fold(&r, s.humidity);
+		}
+		lap(&r);
+	}
+	stop(&r, "acquire_single_int32", calls);
+#endif
+
+#if BME280_USE_DOUBLE
+	start(&r);
+	for (uint32_t k = 0 ; k < repeat ; k++){
+		for (uint32_t i = 0 ; i < n ; i++){
+			load_sample(i);
+			sensor.forced();
+			sensor.read_adc_burst();
+			fold(&r, llround(sensor.temperature_dbl() * 1000.0));
+			fold(&r, llround(sensor.pressure_dbl() * 1000.0));
+			fold(&r, llround(sensor.humidity_dbl() * 1000.0));
+		}
+		lap(&r);
+	}
+	stop(&r, "acquire_burst_double", calls);
+#endif
+}
+
+int main(int argc, char **argv){
+	uint32_t clock_hz = 100000;
+	int      traces   = 0;
+
+	for (int i = 1 ; i < argc ; i++){
+		if (strcmp(argv[i], "--clock") == 0 && i + 1 < argc){
+			clock_hz = (uint32_t)strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc){
+			repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+			repeat = repeat ? repeat : 1;
+		} else if (strcmp(argv[i], "--realtime") == 0){
+			Wire.realtime = true;
+		} else if (strcmp(argv[i], "--json") == 0){
+			json = true;
+		} else if (argv[i][0] == '-'){
+			fprintf(stderr, "usage: %s [--clock <hz>] [--repeat <n>] [--realtime] [--json] <trace>...\n", argv[0]);
+			return 1;
+		}
+	}
+	Wire.setClock(clock_hz);
+
+	printf("# BME280_Replay clock_hz=%u repeat=%u realtime=%u lut=%u compiler=\"%s\"\n",
+		   Wire.clock_hz, repeat, Wire.realtime, BME280_USE_LUT, __VERSION__);
+	if ( !json ){
+		printf("trace,op,calls,wall_ns,cpu_ns,bus_ns,transactions,bytes,checksum\n");
+	}
+	for (int i = 1 ; i < argc ; i++){
+		if (argv[i][0] == '-'){
+			if (strcmp(argv[i], "--clock") == 0 || strcmp(argv[i], "--repeat") == 0){
+				i++;
+			}
+			continue;
+		}
+		if ( !load_trace(argv[i]) ){
+			return 1;
+		}
+		replay();
+		traces++;
+	}
+	if ( !traces ){
+		fprintf(stderr, "no trace given\n");
+		return 1;
+	}
+	return 0;
+}
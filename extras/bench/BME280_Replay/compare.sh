@@ -0,0 +1,101 @@
+#!/bin/sh
+#
+#  BOSCH BME280 Sensor Library. Compare two Runs of BME280_Replay.
+#
+#  Joins both Runs on Trace and Operation and prints the CPU and Wall
+#  Time Ratio new/old. Each Run may be CSV (default) or JSON Lines ('--json'),
+#  JSON Lines are turned into the CSV Columns first. Bus Time, Transactions, Bytes and Checksum are
+#  deterministic, any Difference there is marked: the Driver changed its
+#  Bus Traffic or its Results.
+#
+#  Run:  sh compare.sh old.csv new.csv
+#        sh compare.sh old.json new.json
+#        THRESHOLD=1.10 sh compare.sh old.csv new.csv   (mark CPU Ratios above)
+#
+#  Both Runs need the same 'clock_hz', 'repeat', 'realtime' and 'lut' in their
+#  '# BME280_Replay' Header, else they are not compared.
+#
+#  Exit: 0 no Change, 1 deterministic Column changed or Operation missing,
+#        2 Usage, different Run Settings or a JSON Line of another Format
+#
+#  Written by Pascal Droege (GER) for private use.
+#  BSD license, all text above must be included in any redistribution
+#
+
+if [ $# -ne 2 ]; then
+	echo "usage: $0 old.csv|old.json new.csv|new.json" >&2
+	exit 2
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+settings() {
+	sed -n 's/^# BME280_Replay \(clock_hz=[^ ]* repeat=[^ ]* realtime=[^ ]* lut=[^ ]*\).*/\1/p' "$1"
+}
+OLD=$(settings "$1")
+NEW=$(settings "$2")
+if [ -z "$OLD" ] || [ "$OLD" != "$NEW" ]; then
+	echo "different run settings, not compared:" >&2
+	echo "  $1: ${OLD:-no BME280_Replay header}" >&2
+	echo "  $2: ${NEW:-no BME280_Replay header}" >&2
+	exit 2
+fi
+
+# CSV Rows of one Run: JSON Lines in the Key Order of BME280_Replay, CSV as is
+rows() {
+	sed -e 's/^{"trace":"\([^"]*\)","op":"\([^"]*\)","calls":\([^,]*\),"wall_ns":\([^,]*\),"cpu_ns":\([^,]*\),"bus_ns":\([^,]*\),"transactions":\([^,]*\),"bytes":\([^,]*\),"checksum":"\([^"]*\)"}$/\1,\2,\3,\4,\5,\6,\7,\8,\9/' "$1"
+}
+rows "$1" > "$TMP/old"
+rows "$2" > "$TMP/new"
+
+awk -F, -v threshold="${THRESHOLD:-1.10}" '
+	/^#/ || $1 == "trace" { next }
+	/^{/ {
+		print "unknown JSON line: " $0 > "/dev/stderr"
+		bad = 1
+		exit
+	}
+	FNR == NR {
+		key = $1 "," $2
+		wall[key] = $4; cpu[key] = $5; det[key] = $6 "," $7 "," $8 "," $9
+		next
+	}
+	{
+		key = $1 "," $2
+		if ( !(key in cpu) ){
+			printf "%-26s %-22s %s\n", $1, $2, "new operation"
+			changed = 1
+			next
+		}
+		seen[key] = 1
+		note = ""
+		if (det[key] != $6 "," $7 "," $8 "," $9){
+			split(det[key], o, ",")
+			if (o[1] != $6) note = note " bus_ns " o[1] "->" $6
+			if (o[2] != $7) note = note " transactions " o[2] "->" $7
+			if (o[3] != $8) note = note " bytes " o[3] "->" $8
+			if (o[4] != $9) note = note " checksum"
+			changed = 1
+		}
+		rc = (cpu[key]  > 0) ? $5 / cpu[key]  : 0
+		rw = (wall[key] > 0) ? $4 / wall[key] : 0
+		if (rc > threshold){
+			note = "slower" note
+		}
+		printf "%-26s %-22s cpu %6.3f  wall %6.3f  %s\n", $1, $2, rc, rw, note
+	}
+	END {
+		if (bad){
+			exit 2
+		}
+		for (key in cpu){
+			if ( !(key in seen) ){
+				split(key, k, ",")
+				printf "%-26s %-22s %s\n", k[1], k[2], "missing"
+				changed = 1
+			}
+		}
+		exit changed
+	}
+' "$TMP/old" "$TMP/new"
@@ -0,0 +1,456 @@
+/**
+ *  \file BME280_Sweep.cpp
+ *  \brief BOSCH BME280 Sensor Library. Accuracy versus Cost of all Compensation Variants.
+ *
+ *  \details Linux Harness. Runs every 'compensate_*' Variant over the raw ADC Range of the Operating Range
+ *  \details ( -40 ... 85 DegC, 300 ... 1100 hPa, 0 ... 100 %rH ) and compares against a long double Reference
+ *  \details of the Datasheet Formulas. Reports max and RMS Error and ns per Sample for each Calibration Set.
+ *  \details Temperature: every adc_T. Pressure and Humidity: at every full DegC, every 'SWEEP_P_STRIDE'th adc_P and
+ *  \details every 'SWEEP_H_STRIDE'th adc_H, plus every adc_P and adc_H at -40, 0, 25, 60 and 85 DegC.
+ *  \details Limits: the Reference is the Datasheet 'double' Formula evaluated in long double, not an independent Model
+ *  \details of the Sensor. It measures how far each Variant is from the Datasheet Definition; the '*_double' Variants
+ *  \details are the same Formula and only show double Rounding, about 0 by Construction.
+ *  \details With '-DBME280_USE_LUT=1' the Table Variants are added, '*_lut' against the Reference,
+ *  \details '*_lut_i32' against the BOSCH Integer Formulas. 'H_lut' uses the 't_fine' of 'compensate_T_lut()'.
+ *  \details The Table Humidity is swept densely over t_fine: every 'SWEEP_LUT_T_STRIDE'th adc_T plus every Node and
+ *  \details Segment Midpoint of both Tables, each with every 'SWEEP_LUT_H_STRIDE'th adc_H.
+ *  \details
+ *  \details Build:  g++ -O2 -std=c++17 -I../../host -I../../.. BME280_Sweep.cpp ../../../BME280_I2C.cpp -o BME280_Sweep
+ *  \details         g++ -O2 -std=c++17 -DBME280_USE_LUT=1 -DBME280_LUT_T_BITS=5 -DBME280_LUT_H_BITS=5 ...   (Table Variants)
+ *  \details Run:    ./BME280_Sweep [--csv] [--calib <52 hex chars 0x88-0xA1> <14 hex chars 0xE1-0xE7>]
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "Arduino.h"
+#include <Wire.h>
+#include "BME280_I2C.h"
+#include "BME280_Fake.h"
+
+/***********************************************************************
+ *  Calibration Sets
+ *  'datasheet' is the Example of the Datasheet, the others are typical
+ *  Values of Production Parts. Add your own with '--calib'.
+ **********************************************************************/
+typedef struct{
+	const char		 *name;
+	BME280_CALIB_DATA calib;
+} SWEEP_CALIB;
+
+static SWEEP_CALIB calib_sets[8] = {
+	{ "datasheet", BME280_FAKE_CALIB_DATASHEET },
+	{ "typical_a", { 28485, 26735, 50, 37146, -10536, 3024, 6498, -73, -7, 9900, -10230, 4285, 359, 341, 0, 75, 0, 30 } },
+	{ "typical_b", { 27945, 26462, 50, 37854, -10544, 3024, 7923, -136, -7, 9900, -10230, 4285, 370, 307, 50, 75, 0, 30 } },
+};
+static uint8_t calib_count = 3;
+
+/***********************************************************************
+ *  Reference: Datasheet 'double' Formulas in long double
+ **********************************************************************/
+typedef long double ldouble;
+
+static ldouble ref_t_fine(const BME280_CALIB_DATA *c, int32_t adc_T){
+	ldouble var1 = ((ldouble)adc_T / 16384.0L - (ldouble)c->dig_T1 / 1024.0L) * (ldouble)c->dig_T2;
+	ldouble var2 = ((ldouble)adc_T / 131072.0L - (ldouble)c->dig_T1 / 8192.0L);
+	var2 = var2 * var2 * (ldouble)c->dig_T3;
+	return var1 + var2;
+}
+
+static ldouble ref_P(const BME280_CALIB_DATA *c, int32_t t_fine, int32_t adc_P){
+	ldouble var1, var2, P;
+	var1 = (ldouble)t_fine / 2.0L - 64000.0L;
+	var2 = var1 * var1 * (ldouble)c->dig_P6 / 32768.0L;
+	var2 = var2 + var1 * (ldouble)c->dig_P5 * 2.0L;
+	var2 = var2 / 4.0L + (ldouble)c->dig_P4 * 65536.0L;
+	var1 = ((ldouble)c->dig_P3 * var1 * var1 / 524288.0L + (ldouble)c->dig_P2 * var1) / 524288.0L;
+	var1 = (1.0L + var1 / 32768.0L) * (ldouble)c->dig_P1;
+	if (var1 == 0.0L){
+		return 0.0L;
+	}
+	P = 1048576.0L - (ldouble)adc_P;
+	P = (P - var2 / 4096.0L) * 6250.0L / var1;
+	var1 = (ldouble)c->dig_P9 * P * P / 2147483648.0L;
+	var2 = P * (ldouble)c->dig_P8 / 32768.0L;
+	return P + (var1 + var2 + (ldouble)c->dig_P7) / 16.0L;
+}
+
+static ldouble ref_H(const BME280_CALIB_DATA *c, int32_t t_fine, int32_t adc_H){
+	ldouble H = (ldouble)t_fine - 76800.0L;
+	H = ((ldouble)adc_H - ((ldouble)c->dig_H4 * 64.0L + (ldouble)c->dig_H5 / 16384.0L * H)) *
+		((ldouble)c->dig_H2 / 65536.0L * (1.0L + (ldouble)c->dig_H6 / 67108864.0L * H * (1.0L + (ldouble)c->dig_H3 / 67108864.0L * H)));
+	H = H * (1.0L - (ldouble)c->dig_H1 * H / 524288.0L);
+	return H > 100.0L ? 100.0L : (H < 0.0L ? 0.0L : H);
+}
+
+/***********************************************************************
+ *  Statistics
+ **********************************************************************/
+typedef struct{
+	const char *variant;
+	const char *unit;
+	double		max;
+	double		sum2;
+	uint64_t	n;
+	uint64_t	ns;
+} SWEEP_STAT;
+
+static void stat_add(SWEEP_STAT *s, ldouble value, ldouble ref){
+	double e = (double)fabsl(value - ref);
+	if (e > s->max){
+		s->max = e;
+	}
+	s->sum2 += e * e;
+	s->n++;
+}
+
+static uint64_t now_ns(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static volatile double sink;
+
+#if BME280_USE_LUT
+#define SWEEP_VARIANTS					11
+#ifndef SWEEP_LUT_T_STRIDE
+#define SWEEP_LUT_T_STRIDE				7			// adc_T Step of the dense Humidity Sweep, about 57000 Temperatures
+#endif
+#ifndef SWEEP_LUT_H_STRIDE
+#define SWEEP_LUT_H_STRIDE				8			// adc_H Step at each Temperature
+#endif
+static uint32_t h_int32[1 << 16];
+#else
+#define SWEEP_VARIANTS					7
+#endif
+#ifndef SWEEP_P_STRIDE
+#define SWEEP_P_STRIDE					4			// adc_P Step at each full DegC
+#endif
+#ifndef SWEEP_H_STRIDE
+#define SWEEP_H_STRIDE					1			// adc_H Step at each full DegC
+#endif
+
+#if BME280_USE_LUT
+/***********************************************************************
+ *  Dense Table Humidity Sweep
+ **********************************************************************/
+
+/**
+ *  \brief Table Humidity at one Temperature against Reference and Integer Formula
+ */
+static void lut_h_point(BME280_I2C *sensor, const BME280_CALIB_DATA *c, int32_t adc_T, SWEEP_STAT *vs_ref, SWEEP_STAT *vs_i32){
+	int32_t t_fine = (int32_t)ref_t_fine(c, adc_T);
+	int32_t adc;
+
+	sensor->compensate_T_int32(adc_T);
+	for (adc = 0 ; adc < (1 << 16) ; adc += SWEEP_LUT_H_STRIDE){
+		h_int32[adc] = sensor->compensate_H_int32(adc);
+	}
+	sensor->compensate_T_lut(adc_T);						// '_t_fine' of the Table, as on the Read Path
+	for (adc = 0 ; adc < (1 << 16) ; adc += SWEEP_LUT_H_STRIDE){
+		ldouble h = (ldouble)sensor->compensate_H_lut(adc) / 1024.0L;
+		stat_add(vs_ref, h, ref_H(c, t_fine, adc));
+		stat_add(vs_i32, h, (ldouble)h_int32[adc] / 1024.0L);
+	}
+}
+
+/**
+ *  \brief Smallest adc_T in [lo, hi) with t_fine >= 'target'
+ */
+static int32_t lut_adc_T_at(const BME280_CALIB_DATA *c, ldouble target, int32_t lo, int32_t hi){
+	while (lo < hi){
+		int32_t mid = lo + (hi - lo) / 2;
+		if (ref_t_fine(c, mid) < target){
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ *  \brief Table Humidity over -40 ... 85 DegC
+ *
+ *  \details Strided adc_T, every Node and Segment Midpoint of the t_fine Table and of the Humidity Factor Table
+ */
+static void lut_h_sweep(BME280_I2C *sensor, const BME280_CALIB_DATA *c, int32_t adc_lo, int32_t adc_hi, SWEEP_STAT *vs_ref, SWEEP_STAT *vs_i32){
+	const int32_t t_seg = 1L << (20 - BME280_LUT_T_BITS);
+	const int32_t h_seg = 1L << (BME280_LUT_H_SPAN_BITS - BME280_LUT_H_BITS);
+	int32_t adc;
+
+	for (adc = adc_lo ; adc < adc_hi ; adc += SWEEP_LUT_T_STRIDE){
+		lut_h_point(sensor, c, adc, vs_ref, vs_i32);
+	}
+	for (int32_t i = 0 ; i < (1L << BME280_LUT_T_BITS) ; i++){
+		for (int32_t half = 0 ; half < 2 ; half++){
+			adc = i * t_seg + half * (t_seg / 2);
+			if (adc >= adc_lo && adc < adc_hi){
+				lut_h_point(sensor, c, adc, vs_ref, vs_i32);
+			}
+		}
+	}
+	for (int32_t i = 0 ; i < (1L << BME280_LUT_H_BITS) ; i++){
+		for (int32_t half = 0 ; half < 2 ; half++){
+			ldouble target = (ldouble)(BME280_LUT_H_BASE + i * h_seg + half * (h_seg / 2));
+			adc = lut_adc_T_at(c, target, adc_lo, adc_hi);
+			if (adc > adc_lo && adc < adc_hi){
+				lut_h_point(sensor, c, adc - 1, vs_ref, vs_i32);
+				lut_h_point(sensor, c, adc, vs_ref, vs_i32);
+			}
+		}
+	}
+}
+#endif
+
+/***********************************************************************
+ *  Sweep one Calibration Set
+ **********************************************************************/
+static void sweep(const SWEEP_CALIB *set, bool csv){
+	BME280_I2C  sensor;
+	BME280_Fake fake;
+	SWEEP_STAT  st[SWEEP_VARIANTS] = {
+		{ "T_int32",  "DegC", 0, 0, 0, 0 },
+		{ "T_double", "DegC", 0, 0, 0, 0 },
+		{ "P_int32",  "Pa",   0, 0, 0, 0 },
+		{ "P_int64",  "Pa",   0, 0, 0, 0 },
+		{ "P_double", "Pa",   0, 0, 0, 0 },
+		{ "H_int32",  "%rH",  0, 0, 0, 0 },
+		{ "H_double", "%rH",  0, 0, 0, 0 },
+#if BME280_USE_LUT
+		{ "T_lut",     "DegC", 0, 0, 0, 0 },
+		{ "T_lut_i32", "DegC", 0, 0, 0, 0 },
+		{ "H_lut",     "%rH",  0, 0, 0, 0 },
+		{ "H_lut_i32", "%rH",  0, 0, 0, 0 },
+#endif
+	};
+	static const double temps[5] = { -40.0, 0.0, 25.0, 60.0, 85.0 };
+	const BME280_CALIB_DATA *c = &set->calib;
+	int32_t  adc, adc_T, adc_lo, adc_hi, t_fine;
+	uint64_t t0;
+	double   acc;
+
+	fake.calib(c);
+	Wire.attach(BME280_ADDRESS, fake.regs);
+	if ( !sensor.begin(BME280_ADDRESS) ){
+		fprintf(stderr, "%s: no sensor\n", set->name);
+		return;
+	}
+
+	/*
+	 * Temperature: every adc_T of -40 ... 85 DegC
+	 */
+	for (adc_lo = 0 ; adc_lo < (1 << 20) && ref_t_fine(c, adc_lo) / 5120.0L < -40.0L ; adc_lo++);
+	for (adc_hi = adc_lo ; adc_hi < (1 << 20) && ref_t_fine(c, adc_hi) / 5120.0L <= 85.0L ; adc_hi++);
+
+	for (adc = adc_lo ; adc < adc_hi ; adc++){
+		ldouble ref = ref_t_fine(c, adc) / 5120.0L;
+		stat_add(&st[0], (ldouble)sensor.compensate_T_int32(adc) / 100.0L, ref);
+		stat_add(&st[1], (ldouble)sensor.compensate_T_double(adc), ref);
+#if BME280_USE_LUT
+		int32_t t_lut = sensor.compensate_T_lut(adc);
+		stat_add(&st[7], (ldouble)t_lut / 100.0L, ref);
+		stat_add(&st[8], (ldouble)t_lut / 100.0L, (ldouble)sensor.compensate_T_int32(adc) / 100.0L);
+#endif
+	}
+	acc = 0;
+	t0 = now_ns();
+	for (adc = adc_lo ; adc < adc_hi ; adc++){
+		acc += sensor.compensate_T_int32(adc);
+	}
+	st[0].ns = now_ns() - t0;
+	t0 = now_ns();
+	for (adc = adc_lo ; adc < adc_hi ; adc++){
+		acc += sensor.compensate_T_double(adc);
+	}
+	st[1].ns = now_ns() - t0;
+#if BME280_USE_LUT
+	t0 = now_ns();
+	for (adc = adc_lo ; adc < adc_hi ; adc++){
+		acc += sensor.compensate_T_lut(adc);
+	}
+	st[7].ns = st[8].ns = now_ns() - t0;
+#endif
+
+	/*
+	 * Pressure and Humidity: at every full DegC, dense at the Temperatures of the Timing Loops
+	 * The Reference uses the same integer 't_fine' as the Driver
+	 */
+	adc_T = adc_lo;
+	for (int32_t deg = -40 ; deg <= 85 ; deg++){
+		int32_t sp = SWEEP_P_STRIDE, sh = SWEEP_H_STRIDE;
+		for (uint8_t k = 0 ; k < 5 ; k++){
+			if (deg == (int32_t)temps[k]){
+				sp = sh = 1;
+			}
+		}
+		for ( ; adc_T < adc_hi && ref_t_fine(c, adc_T) / 5120.0L < deg ; adc_T++);
+		sensor.compensate_T_double(adc_T);					// sets '_t_fine' = (int32_t) t_fine
+		t_fine = (int32_t)ref_t_fine(c, adc_T);
+
+		for (adc = 0 ; adc < (1 << 20) ; adc += sp){
+			ldouble ref = ref_P(c, t_fine, adc);
+			if (ref < 30000.0L || ref > 110000.0L){
+				continue;
+			}
+			stat_add(&st[2], (ldouble)sensor.compensate_P_int32(adc), ref);
+			stat_add(&st[3], (ldouble)sensor.compensate_P_int64(adc), ref);
+			stat_add(&st[4], (ldouble)sensor.compensate_P_double(adc), ref);
+		}
+		for (adc = 0 ; adc < (1 << 16) ; adc += sh){
+			ldouble ref = ref_H(c, t_fine, adc);
+			stat_add(&st[5], (ldouble)sensor.compensate_H_int32(adc) / 1024.0L, ref);
+			stat_add(&st[6], (ldouble)sensor.compensate_H_double(adc), ref);
+		}
+	}
+
+	/*
+	 * Timing: every adc_P and adc_H at the 5 fixed Temperatures
+	 */
+	for (uint8_t k = 0 ; k < 5 ; k++){
+		for (adc_T = adc_lo ; adc_T < adc_hi && ref_t_fine(c, adc_T) / 5120.0L < temps[k] ; adc_T++);
+		sensor.compensate_T_double(adc_T);
+#if BME280_USE_LUT
+		sensor.compensate_T_lut(adc_T);						// '_t_fine' of the Table, as on the Read Path
+		t0 = now_ns();
+		for (adc = 0 ; adc < (1 << 16) ; adc++){
+			acc += sensor.compensate_H_lut(adc);
+		}
+		st[9].ns += now_ns() - t0;
+		st[10].ns = st[9].ns;
+		sensor.compensate_T_double(adc_T);
+#endif
+
+		t0 = now_ns();
+		for (adc = 0 ; adc < (1 << 20) ; adc++){
+			acc += sensor.compensate_P_int32(adc);
+		}
+		st[2].ns += now_ns() - t0;
+		t0 = now_ns();
+		for (adc = 0 ; adc < (1 << 20) ; adc++){
+			acc += sensor.compensate_P_int64(adc);
+		}
+		st[3].ns += now_ns() - t0;
+		t0 = now_ns();
+		for (adc = 0 ; adc < (1 << 20) ; adc++){
+			acc += sensor.compensate_P_double(adc);
+		}
+		st[4].ns += now_ns() - t0;
+		t0 = now_ns();
+		for (adc = 0 ; adc < (1 << 16) ; adc++){
+			acc += sensor.compensate_H_int32(adc);
+		}
+		st[5].ns += now_ns() - t0;
+		t0 = now_ns();
+		for (adc = 0 ; adc < (1 << 16) ; adc++){
+			acc += sensor.compensate_H_double(adc);
+		}
+		st[6].ns += now_ns() - t0;
+	}
+	sink = acc;
+
+#if BME280_USE_LUT
+	/*
+	 * Table Humidity: dense over t_fine instead of the fixed Temperatures
+	 */
+	lut_h_sweep(&sensor, c, adc_lo, adc_hi, &st[9], &st[10]);
+#endif
+
+	/*
+	 * Timing Loops run over the full Range, so divide by their own Sample Count
+	 */
+	uint64_t timed[SWEEP_VARIANTS] = {	(uint64_t)(adc_hi - adc_lo), (uint64_t)(adc_hi - adc_lo),
+										5ULL << 20, 5ULL << 20, 5ULL << 20, 5ULL << 16, 5ULL << 16,
+#if BME280_USE_LUT
+										(uint64_t)(adc_hi - adc_lo), (uint64_t)(adc_hi - adc_lo), 5ULL << 16, 5ULL << 16
+#endif
+									};
+	for (uint8_t i = 0 ; i < SWEEP_VARIANTS ; i++){
+		double rms = st[i].n ? sqrt(st[i].sum2 / (double)st[i].n) : 0.0;
+		double ns  = (double)st[i].ns / (double)timed[i];
+		if (csv){
+			printf("%s,%s,%s,%.6f,%.6f,%llu,%.2f\n", set->name, st[i].variant, st[i].unit,
+				   st[i].max, rms, (unsigned long long)st[i].n, ns);
+		} else {
+			printf("| %-10s | %-9s | %-5s | %12.6f | %12.6f | %10llu | %8.2f |\n", set->name, st[i].variant, st[i].unit,
+				   st[i].max, rms, (unsigned long long)st[i].n, ns);
+		}
+	}
+}
+
+/***********************************************************************
+ *  Parse Calibration from Register Dumps, same Decoding as 'read_coeff()'
+ **********************************************************************/
+static bool parse_calib(const char *hex_88, const char *hex_e1, BME280_CALIB_DATA *c){
+	uint8_t  r[256];
+	unsigned v;
+
+	if (strlen(hex_88) != 52 || strlen(hex_e1) != 14){
+		return false;
+	}
+	for (uint8_t i = 0 ; i < 26 ; i++){
+		if (sscanf(hex_88 + 2 * i, "%2x", &v) != 1){
+			return false;
+		}
+		r[0x88 + i] = (uint8_t)v;
+	}
+	for (uint8_t i = 0 ; i < 7 ; i++){
+		if (sscanf(hex_e1 + 2 * i, "%2x", &v) != 1){
+			return false;
+		}
+		r[0xE1 + i] = (uint8_t)v;
+	}
+	c->dig_T1 = (uint16_t)(r[0x88] | (r[0x89] << 8));
+	c->dig_T2 = (int16_t)(r[0x8A] | (r[0x8B] << 8));
+	c->dig_T3 = (int16_t)(r[0x8C] | (r[0x8D] << 8));
+	c->dig_P1 = (uint16_t)(r[0x8E] | (r[0x8F] << 8));
+	c->dig_P2 = (int16_t)(r[0x90] | (r[0x91] << 8));
+	c->dig_P3 = (int16_t)(r[0x92] | (r[0x93] << 8));
+	c->dig_P4 = (int16_t)(r[0x94] | (r[0x95] << 8));
+	c->dig_P5 = (int16_t)(r[0x96] | (r[0x97] << 8));
+	c->dig_P6 = (int16_t)(r[0x98] | (r[0x99] << 8));
+	c->dig_P7 = (int16_t)(r[0x9A] | (r[0x9B] << 8));
+	c->dig_P8 = (int16_t)(r[0x9C] | (r[0x9D] << 8));
+	c->dig_P9 = (int16_t)(r[0x9E] | (r[0x9F] << 8));
+	c->dig_H1 = r[0xA1];
+	c->dig_H2 = (int16_t)(r[0xE1] | (r[0xE2] << 8));
+	c->dig_H3 = r[0xE3];
+	c->dig_H4 = (int16_t)((r[0xE4] << 4) | (r[0xE5] & 0x0F));
+	c->dig_H5 = (int16_t)((r[0xE6] << 4) | (r[0xE5] >> 4));
+	c->dig_H6 = (int8_t)r[0xE7];
+	return true;
+}
+
+int main(int argc, char **argv){
+	bool csv = false;
+
+	for (int i = 1 ; i < argc ; i++){
+		if (strcmp(argv[i], "--csv") == 0){
+			csv = true;
+		} else if (strcmp(argv[i], "--calib") == 0 && i + 2 < argc && calib_count < 8){
+			if ( !parse_calib(argv[i + 1], argv[i + 2], &calib_sets[calib_count].calib) ){
+				fprintf(stderr, "--calib: expected 52 and 14 hex characters\n");
+				return 1;
+			}
+			calib_sets[calib_count++].name = "custom";
+			i += 2;
+		} else {
+			fprintf(stderr, "usage: %s [--csv] [--calib <hex 0x88-0xA1> <hex 0xE1-0xE7>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (csv){
+		printf("calib,variant,unit,max_err,rms_err,samples,ns_per_sample\n");
+	} else {
+		printf("| calib      | variant   | unit  |      max_err |      rms_err |    samples | ns/smpl  |\n");
+		printf("|------------|-----------|-------|-------------:|-------------:|-----------:|---------:|\n");
+	}
+	for (uint8_t i = 0 ; i < calib_count ; i++){
+		sweep(&calib_sets[i], csv);
+	}
+	return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ *  \file Arduino.h
+ *  \brief BOSCH BME280 Sensor Library. Host Stand-In for the Arduino Core.
+ *
+ *  \details Only what the Library needs to compile and run on Linux: Types, Math and Timing
+ *  \details Used by the Benchmarks in 'extras/bench', never by a Sketch
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_HOST_ARDUINO_H__
+#define __BME280_HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+/**
+ *  \brief Microseconds since an arbitrary Start, CLOCK_MONOTONIC
+ */
+inline uint32_t micros(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+/**
+ *  \brief Milliseconds since an arbitrary Start, CLOCK_MONOTONIC
+ */
+inline uint32_t millis(void){
+	return micros() / 1000;
+}
+
+/**
+ *  \brief Sleep for given Milliseconds
+ */
+inline void delay(uint32_t ms){
+	struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+	nanosleep(&ts, NULL);
+}
+
+/**
+ *  \brief Sleep for given Microseconds
+ */
+inline void delayMicroseconds(uint32_t us){
+	struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000L };
+	nanosleep(&ts, NULL);
+}
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ *  \file BME280_Fake.h
+ *  \brief BOSCH BME280 Sensor Library. Register File of a simulated BME280.
+ *
+ *  \details Chip ID, Calibration Data and ADC Registers at the Addresses of the Datasheet
+ *  \details Attach 'regs' to the Host Stand-In of 'Wire' to run the Library without Hardware
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_FAKE_H__
+#define __BME280_FAKE_H__
+
+#include "BME280_I2C.h"
+
+/***********************************************************************
+ *  BME280 Calibration Set from the Datasheet Example
+ **********************************************************************/
+#define BME280_FAKE_CALIB_DATASHEET		{ 27504, 26435, -1000, \
+										  36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000, \
+										  362, 313, 50, 75, 0, 30 }
+
+/***********************************************************************
+ *  BME280_FAKE CLASS
+ **********************************************************************/
+class BME280_Fake{
+	public:
+
+		/**
+		 *  \brief Empty Register File with Chip ID 0x60
+		 */
+		BME280_Fake(void){
+			memset(regs, 0, sizeof(regs));
+			regs[BME280_REGISTER_CHIPID] = 0x60;
+			adc(0x80000, 0x80000, 0x8000);
+		}
+
+		/**
+		 *  \brief Write Calibration Data into the NVM Registers
+		 *
+		 *  \param [in] c Calibration Data
+		 *
+		 *  \details 0x88 - 0x9F: dig_T1 - dig_P9 Little Endian, 0xA1: dig_H1, 0xE1 - 0xE7: dig_H2 - dig_H6
+		 */
+		void calib(const BME280_CALIB_DATA *c){
+			const uint16_t tp[12] = {	(uint16_t)c->dig_T1, (uint16_t)c->dig_T2, (uint16_t)c->dig_T3,
+										(uint16_t)c->dig_P1, (uint16_t)c->dig_P2, (uint16_t)c->dig_P3,
+										(uint16_t)c->dig_P4, (uint16_t)c->dig_P5, (uint16_t)c->dig_P6,
+										(uint16_t)c->dig_P7, (uint16_t)c->dig_P8, (uint16_t)c->dig_P9 };
+			for (uint8_t i = 0 ; i < 12 ; i++){
+				regs[BME280_REGISTER_DIG_T1 + 2 * i]     = tp[i] & 0xFF;
+				regs[BME280_REGISTER_DIG_T1 + 2 * i + 1] = tp[i] >> 8;
+			}
+			regs[BME280_REGISTER_DIG_H1]     = c->dig_H1;
+			regs[BME280_REGISTER_DIG_H2]     = (uint16_t)c->dig_H2 & 0xFF;
+			regs[BME280_REGISTER_DIG_H2 + 1] = (uint16_t)c->dig_H2 >> 8;
+			regs[BME280_REGISTER_DIG_H3]     = c->dig_H3;
+			regs[BME280_REGISTER_DIG_H4]     = (uint8_t)(c->dig_H4 >> 4);
+			regs[BME280_REGISTER_DIG_H4 + 1] = (uint8_t)((c->dig_H4 & 0x0F) | ((c->dig_H5 & 0x0F) << 4));
+			regs[BME280_REGISTER_DIG_H5 + 1] = (uint8_t)(c->dig_H5 >> 4);
+			regs[BME280_REGISTER_DIG_H6]     = (uint8_t)c->dig_H6;
+		}
+
+		/**
+		 *  \brief Write raw ADC Values into the Data Registers
+		 *
+		 *  \param [in] P adc_P, 20 bit
+		 *  \param [in] T adc_T, 20 bit
+		 *  \param [in] H adc_H, 16 bit
+		 */
+		void adc(int32_t P, int32_t T, int32_t H){
+			regs[BME280_REGISTER_PRESSUREDATA]     = (uint8_t)(P >> 12);
+			regs[BME280_REGISTER_PRESSUREDATA + 1] = (uint8_t)(P >> 4);
+			regs[BME280_REGISTER_PRESSUREDATA + 2] = (uint8_t)(P << 4);
+			regs[BME280_REGISTER_TEMPDATA]         = (uint8_t)(T >> 12);
+			regs[BME280_REGISTER_TEMPDATA + 1]     = (uint8_t)(T >> 4);
+			regs[BME280_REGISTER_TEMPDATA + 2]     = (uint8_t)(T << 4);
+			regs[BME280_REGISTER_HUMIDDATA]        = (uint8_t)(H >> 8);
+			regs[BME280_REGISTER_HUMIDDATA + 1]    = (uint8_t)H;
+		}
+
+		uint8_t regs[256];
+};
+
+#endif
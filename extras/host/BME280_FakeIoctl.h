@@ -0,0 +1,107 @@
+/**
+ *  \file BME280_FakeIoctl.h
+ *  \brief BOSCH BME280 Sensor Library. In-Process Stand-In for the Linux 'I2C_RDWR' ioctl.
+ *
+ *  \details I2C Bus in Memory for the Linux Backend ('BME280_LINUX' = 1). Every Device is a Register File of 256 Bytes at one 7 bit Address
+ *  \details A Write Message is Register/Value Pairs like on the BME280 (Datasheet | 6.2.1), a single Byte only sets the Register Pointer
+ *  \details A Read Message starts at the Register Pointer, with Auto-Increment
+ *  \details Counts ioctl Calls, Messages and Bytes on the Bus, the Address Byte of every Message included
+ *  \details
+ *  \details Usage:  sensor.bus_attach(0, bme280_fake_ioctl);  FakeBus.attach(0x76, fake.regs);
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_FAKE_IOCTL_H__
+#define __BME280_FAKE_IOCTL_H__
+
+#include <errno.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "BME280_I2C.h"
+
+/***********************************************************************
+ *  BME280_FAKEBUS CLASS
+ **********************************************************************/
+class BME280_FakeBus{
+	public:
+
+		/**
+		 *  \brief Place a Register File on the Bus
+		 *
+		 *  \param [in] address 7 bit I2C Address
+		 *  \param [in] regs 256 Bytes Register File, NULL removes the Device
+		 */
+		void	 attach(uint8_t address, uint8_t *regs){
+			_dev[address & 0x7F] = regs;
+			_ptr[address & 0x7F] = 0;
+		}
+
+		/**
+		 *  \brief Handle one ioctl like the i2c-dev Driver
+		 *
+		 *  \param [in] request only 'I2C_RDWR' is supported
+		 *  \param [in] arg 'struct i2c_rdwr_ioctl_data'
+		 *  \return Number of Messages, or -1 with 'errno' = ENXIO if a Device does not answer
+		 */
+		int		 ioctl(unsigned long request, void *arg){
+			struct i2c_rdwr_ioctl_data *x = (struct i2c_rdwr_ioctl_data *)arg;
+			calls++;
+			if (request != I2C_RDWR || x == NULL || x->nmsgs == 0 || x->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS){
+				errno = EINVAL;
+				return -1;
+			}
+			for (uint32_t m = 0 ; m < x->nmsgs ; m++){
+				struct i2c_msg *msg = &x->msgs[m];
+				uint8_t a = msg->addr & 0x7F;
+				messages++;
+				bytes += 1 + msg->len;
+				if (_dev[a] == NULL){
+					errno = ENXIO;
+					return -1;
+				}
+				for (uint16_t i = 0 ; i < msg->len ; i++){
+					if (msg->flags & I2C_M_RD){
+						msg->buf[i] = _dev[a][_ptr[a]++];
+					} else if (i % 2 == 0){
+						_ptr[a] = msg->buf[i];
+					} else {
+						_dev[a][_ptr[a]] = msg->buf[i];
+					}
+				}
+			}
+			return (int)x->nmsgs;
+		}
+
+		/**
+		 *  \brief Reset Bus Counters
+		 */
+		void	 reset_counters(void){
+			calls = 0;
+			messages = 0;
+			bytes = 0;
+		}
+
+		uint32_t calls					= 0;
+		uint32_t messages				= 0;
+		uint32_t bytes					= 0;
+
+	private:
+		uint8_t	*_dev[128]				= { NULL };
+		uint8_t	 _ptr[128]				= { 0 };
+};
+
+inline BME280_FakeBus FakeBus;
+
+/**
+ *  \brief 'BME280_IOCTL' of the Fake Bus
+ *
+ *  \details The File Descriptor is ignored, every Sensor shares 'FakeBus'
+ */
+inline int bme280_fake_ioctl(int fd, unsigned long request, void *arg){
+	(void)fd;
+	return FakeBus.ioctl(request, arg);
+}
+
+#endif
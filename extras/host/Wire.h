@@ -0,0 +1,171 @@
+/**
+ *  \file Wire.h
+ *  \brief BOSCH BME280 Sensor Library. Host Stand-In for the Arduino 'Wire' Library.
+ *
+ *  \details I2C Bus in Memory. Every Device is a Register File of 256 Bytes at one 7 bit Address
+ *  \details The first Byte of a Write sets the Register Pointer, every further Byte is written with Auto-Increment
+ *  \details Reads start at the Register Pointer, also with Auto-Increment
+ *  \details Counts Transactions and Bytes on the Bus, the Address Byte included
+ *  \details Bus Time Model: every Transaction is START, 9 Bit per Byte (ACK included) and STOP at 'setClock()', default 100 kHz
+ *  \details With 'realtime' set, every Transaction also sleeps for its Bus Time, so it adds Wall Time but no CPU Time.
+ *  \details The Overshoot of one Sleep is taken from the next ones, the Wall Time follows the Model on Average
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#ifndef __BME280_HOST_WIRE_H__
+#define __BME280_HOST_WIRE_H__
+
+#include <errno.h>
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH				32
+
+/***********************************************************************
+ *  TWOWIRE CLASS
+ **********************************************************************/
+class TwoWire{
+	public:
+
+		void	 begin(void){}
+		void	 begin(int sda, int scl){ (void)sda; (void)scl; }
+
+		/**
+		 *  \brief Bus Clock of the Time Model
+		 *
+		 *  \param [in] hz SCL Frequency, e.g. 100000 or 400000
+		 */
+		void	 setClock(uint32_t hz){
+			clock_hz = hz ? hz : 100000;
+		}
+
+		/**
+		 *  \brief Place a Register File on the Bus
+		 *
+		 *  \param [in] address 7 bit I2C Address
+		 *  \param [in] regs 256 Bytes Register File, NULL removes the Device
+		 */
+		void	 attach(uint8_t address, uint8_t *regs){
+			_dev[address & 0x7F] = regs;
+			_ptr[address & 0x7F] = 0;
+		}
+
+		void	 beginTransmission(uint8_t address){
+			_addr    = address & 0x7F;
+			_first   = true;
+			_tx_len  = 0;
+		}
+
+		size_t	 write(uint8_t value){
+			_tx_len++;
+			if (_dev[_addr] == NULL){
+				return 1;
+			}
+			if (_first){
+				_ptr[_addr] = value;
+				_first = false;
+			} else {
+				_dev[_addr][_ptr[_addr]++] = value;
+			}
+			return 1;
+		}
+
+		uint8_t	 endTransmission(bool stop = true){
+			(void)stop;
+			transactions++;
+			bytes += 1 + _tx_len;
+			bus(1 + _tx_len);
+			return _dev[_addr] ? 0 : 2;						// 2 = NACK on Address
+		}
+
+		uint8_t	 requestFrom(uint8_t address, uint8_t len){
+			address &= 0x7F;
+			if (len > WIRE_BUFFER_LENGTH){
+				len = WIRE_BUFFER_LENGTH;
+			}
+			transactions++;
+			bytes += 1 + len;
+			bus(1 + len);
+			_rx_pos = 0;
+			_rx_len = 0;
+			if (_dev[address] == NULL){
+				return 0;
+			}
+			for (_rx_len = 0 ; _rx_len < len ; _rx_len++){
+				_rx[_rx_len] = _dev[address][_ptr[address]++];
+			}
+			return len;
+		}
+		uint8_t	 requestFrom(int address, int len){
+			return requestFrom((uint8_t)address, (uint8_t)len);
+		}
+
+		int		 available(void){
+			return _rx_len - _rx_pos;
+		}
+
+		int		 read(void){
+			return (_rx_pos < _rx_len) ? _rx[_rx_pos++] : -1;
+		}
+
+		/**
+		 *  \brief Reset Bus Counters
+		 */
+		void	 reset_counters(void){
+			transactions = 0;
+			bytes = 0;
+			bus_ns = 0;
+			_late_ns = 0;
+		}
+
+		uint32_t transactions			= 0;
+		uint32_t bytes					= 0;
+		uint64_t bus_ns					= 0;		// modelled Bus Time
+		uint32_t clock_hz				= 100000;
+		bool	 realtime				= false;
+
+	private:
+		/**
+		 *  \brief Add the Bus Time of one Transaction
+		 *
+		 *  \param [in] n Bytes of the Transaction, the Address Byte included
+		 */
+		void	 bus(uint32_t n){
+			uint64_t ns = (uint64_t)(2 + 9 * n) * 1000000000ULL / clock_hz;
+			bus_ns += ns;
+			if (realtime){
+				if (ns <= _late_ns){
+					_late_ns -= ns;
+					return;
+				}
+				uint64_t end = now_ns() + ns - _late_ns;
+				struct timespec ts = { (time_t)(end / 1000000000ULL), (long)(end % 1000000000ULL) };
+				while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+				_late_ns = now_ns() - end;
+			}
+		}
+
+		static uint64_t now_ns(void){
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+		}
+
+		uint64_t _late_ns				= 0;		// Sleep Overshoot not yet taken from later Transactions
+
+		uint8_t	*_dev[128]				= { NULL };
+		uint8_t	 _ptr[128]				= { 0 };
+
+		uint8_t	 _addr					= 0;
+		bool	 _first					= false;
+		uint8_t	 _tx_len				= 0;
+
+		uint8_t	 _rx[WIRE_BUFFER_LENGTH];
+		uint8_t	 _rx_len				= 0;
+		uint8_t	 _rx_pos				= 0;
+};
+
+inline TwoWire Wire;
+
+#endif
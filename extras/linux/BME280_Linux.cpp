@@ -0,0 +1,166 @@
+/**
+ *  \file BME280_Linux.cpp
+ *  \brief BOSCH BME280 Sensor Library. Linux Backend on '/dev/i2c-N'.
+ *
+ *  \details Reads a BME280 on a Linux I2C Bus (Raspberry Pi, BeagleBone, ...) with combined 'I2C_RDWR' Transfers
+ *  \details and prints the compensated Samples with the Number of ioctl Calls per Sample.
+ *  \details '--fake' runs the same Code against an in-process simulated BME280, no Hardware needed.
+ *  \details '--trace' records Chip ID, Calibration and raw Data Registers as they pass the ioctl and prints a Trace
+ *  \details for 'extras/bench/BME280_Replay' instead, the Samples follow as Comments.
+ *  \details
+ *  \details Build:  g++ -O2 -std=c++17 -DBME280_LINUX=1 -DBME280_USE_BUDGET=1 -I../host -I../.. BME280_Linux.cpp ../../BME280_I2C.cpp ../../BME280_Format.cpp -o BME280_Linux
+ *  \details Run:    ./BME280_Linux /dev/i2c-1 [address] [samples]
+ *  \details         ./BME280_Linux --fake [address] [samples]
+ *  \details         ./BME280_Linux --trace /dev/i2c-1 [address] [samples] > room.trace
+ *  \details
+ *  \details Written by Pascal Droege (GER) for private use.
+ *  \details BSD license, all text above must be included in any redistribution
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "BME280_I2C.h"
+#include "BME280_Format.h"
+#include "BME280_Fake.h"
+#include "BME280_FakeIoctl.h"
+
+/***********************************************************************
+ *  ioctl Counter
+ **********************************************************************/
+static uint32_t     ioctl_calls = 0;
+static BME280_IOCTL ioctl_next  = NULL;
+static bool         trace       = false;
+static uint8_t      calib_88[26];
+
+static void print_hex(const char *key, const uint8_t *buf, uint8_t len, bool newline){
+	if (key){
+		printf("%s ", key);
+	}
+	for (uint8_t i = 0 ; i < len ; i++){
+		printf("%02x", buf[i]);
+	}
+	printf(newline ? "\n" : " ");
+}
+
+/**
+ *  \brief Trace Recorder
+ *
+ *  \details Register Reads of the Driver are one 'I2C_RDWR' with the Register Address, then the Data.
+ *  \details Chip ID, both Calibration Blocks and the Data Burst from 0xF7 are printed in the Format of 'BME280_Replay'
+ */
+static void record(unsigned long request, void *arg){
+	struct i2c_rdwr_ioctl_data *x = (struct i2c_rdwr_ioctl_data *)arg;
+	uint8_t reg, len, *buf;
+
+	if (request != I2C_RDWR || x->nmsgs != 2 || x->msgs[0].len != 1 || !(x->msgs[1].flags & I2C_M_RD)){
+		return;
+	}
+	reg = x->msgs[0].buf[0];
+	len = (uint8_t)x->msgs[1].len;
+	buf = x->msgs[1].buf;
+	if (reg == BME280_REGISTER_CHIPID && len == 1){
+		printf("chip %02x\n", buf[0]);
+	} else if (reg == BME280_REGISTER_DIG_T1 && len == 26){
+		memcpy(calib_88, buf, 26);
+	} else if (reg == BME280_REGISTER_DIG_H2 && len == 7){
+		print_hex("calib", calib_88, 26, false);
+		print_hex(NULL, buf, 7, true);
+	} else if (reg == BME280_REGISTER_PRESSUREDATA && len == 8){
+		print_hex("data", buf, 8, true);
+	}
+}
+
+static int counting_ioctl(int fd, unsigned long request, void *arg){
+	int ret;
+	ioctl_calls++;
+	ret = ioctl_next(fd, request, arg);
+	if (trace && ret >= 0){
+		record(request, arg);
+	}
+	return ret;
+}
+
+static int kernel_ioctl(int fd, unsigned long request, void *arg){
+	return ioctl(fd, request, arg);
+}
+
+static void sleep_us(uint32_t us){
+	struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+	nanosleep(&ts, NULL);
+}
+
+int main(int argc, char **argv){
+	if (argc > 1 && strcmp(argv[1], "--trace") == 0){
+		trace = true;
+		argv++;
+		argc--;
+	}
+	const char   *device  = (argc > 1) ? argv[1] : "/dev/i2c-1";
+	uint8_t       address = (argc > 2) ? (uint8_t)strtoul(argv[2], NULL, 0) : BME280_ADDRESS;
+	uint32_t      samples = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 10) : 10;
+	bool          fake    = (strcmp(device, "--fake") == 0);
+	BME280_CALIB_DATA calib = BME280_FAKE_CALIB_DATASHEET;
+	BME280_Fake   sim;
+	BME280_I2C    sensor;
+	BME280_SAMPLE s;
+	char          buf[96];
+	BME280_Format out(buf, sizeof(buf));
+	uint32_t      wait_us = BME280_I2C::measure_time_us(BME280_OSRS_P, BME280_OSRS_T, BME280_OSRS_H, true);
+
+	if (fake){
+		sim.calib(&calib);
+		sim.adc(415148, 519888, 0x6000);
+		FakeBus.attach(address, sim.regs);
+		ioctl_next = bme280_fake_ioctl;
+		sensor.bus_attach(0, counting_ioctl);
+	} else {
+		ioctl_next = kernel_ioctl;
+		if ( !sensor.bus_open(device, counting_ioctl) ){
+			perror(device);
+			return 1;
+		}
+	}
+
+	if (trace){
+		printf("# BME280 Trace, %s at 0x%02X, Forced Mode every %u us\n", device, address, wait_us);
+	}
+	ioctl_calls = 0;
+	if ( !sensor.begin(address) ){
+		fprintf(stderr, "no BME280 at 0x%02X on %s\n", address, device);
+		return 1;
+	}
+	if ( !trace ){
+		printf("# begin: %u ioctl\n", ioctl_calls);
+	}
+
+	for (uint32_t i = 0 ; i < samples ; i++){
+		uint32_t forced_calls, read_calls;
+		ioctl_calls = 0;
+		sensor.forced();
+		forced_calls = ioctl_calls;
+		if ( !fake ){
+			sleep_us(wait_us);
+		}
+		ioctl_calls = 0;
+		if ( !sensor.read_adc_burst() ){
+			fprintf(stderr, "read failed on %s\n", device);
+			continue;
+		}
+		read_calls = ioctl_calls;
+		sensor.sample(&s);
+		out.clear();
+		out.plain(&s);
+		if (trace){
+			printf("# %s\n", buf);
+		} else {
+			printf("%s  (forced %u ioctl, read %u ioctl)\n", buf, forced_calls, read_calls);
+		}
+	}
+
+	sensor.bus_close();
+	return 0;
+}
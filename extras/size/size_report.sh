@@ -0,0 +1,96 @@
+#!/bin/sh
+#
+#  BOSCH BME280 Sensor Library. Size Report per Feature Configuration.
+#
+#  Builds a minimal Sketch (begin(), read_adc_burst(), temperature(), pressure(),
+#  humidity()) against the Host Stand-Ins in 'extras/host' for every Configuration
+#  of 'BME280 FEATURE Settings' and links it with '--gc-sections', like the
+#  Arduino Toolchains do. Prints:
+#    sketch    text of the linked Sketch minus text of an empty Program, so only
+#              the Code the Sketch really pulls in: Driver and 'Wire' Stand-In
+#    object    text of BME280_I2C.o, everything the Configuration compiles
+#    data/bss  of the linked Sketch minus the empty Program
+#    instance  RAM of one BME280_I2C Instance, calib the Calibration Data in it
+#  Host Numbers are not Target Numbers, compare them between Revisions.
+#
+#  Run:  sh extras/size/size_report.sh            (from the Library Root)
+#        CXX=clang++ sh extras/size/size_report.sh
+#
+#  Written by Pascal Droege (GER) for private use.
+#  BSD license, all text above must be included in any redistribution
+#
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+CXX=${CXX:-g++}
+SIZE=${SIZE:-size}
+CXXFLAGS=${CXXFLAGS:--Os -std=c++17 -ffunction-sections -fdata-sections}
+LDFLAGS=${LDFLAGS:--Wl,--gc-sections}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+cat > "$TMP/empty.cpp" <<'SRC'
+int main(void){
+	return 0;
+}
+SRC
+
+cat > "$TMP/sketch.cpp" <<'SRC'
+#include <Wire.h>
+#include "BME280_I2C.h"
+BME280_I2C BME280;
+volatile int32_t  sink_T;
+volatile uint32_t sink_P, sink_H;
+int main(void){
+	Wire.begin();
+	if ( !BME280.begin() ){
+		return 1;
+	}
+	BME280.read_adc_burst();
+	sink_T = BME280.temperature();
+	sink_P = BME280.pressure();
+	sink_H = BME280.humidity();
+	return 0;
+}
+SRC
+
+cat > "$TMP/sizeof.cpp" <<'SRC'
+#include <stdio.h>
+#include "BME280_I2C.h"
+int main(void){
+	printf("%u %u\n", (unsigned)sizeof(BME280_I2C), (unsigned)sizeof(BME280_CALIB_DATA));
+	return 0;
+}
+SRC
+
+"$CXX" $CXXFLAGS $LDFLAGS "$TMP/empty.cpp" -o "$TMP/empty"
+set -- $("$SIZE" "$TMP/empty" | tail -n 1)
+TEXT0=$1 DATA0=$2 BSS0=$3
+
+printf "%-12s %8s %8s %8s %8s %10s %10s\n" "config" "sketch" "object" "data" "bss" "instance" "calib"
+
+report() {
+	NAME=$1
+	shift
+	"$CXX" $CXXFLAGS "$@" -I"$ROOT/extras/host" -I"$ROOT" -c "$ROOT/BME280_I2C.cpp" -o "$TMP/$NAME.o"
+	"$CXX" $CXXFLAGS "$@" -I"$ROOT/extras/host" -I"$ROOT" -c "$TMP/sketch.cpp" -o "$TMP/$NAME.sketch.o"
+	"$CXX" $CXXFLAGS $LDFLAGS "$TMP/$NAME.sketch.o" "$TMP/$NAME.o" -o "$TMP/$NAME.sketch"
+	"$CXX" $CXXFLAGS "$@" -I"$ROOT/extras/host" -I"$ROOT" "$TMP/sizeof.cpp" -o "$TMP/$NAME.sizeof"
+	set -- $("$SIZE" "$TMP/$NAME.o" | tail -n 1)
+	OBJECT=$1
+	set -- $("$SIZE" "$TMP/$NAME.sketch" | tail -n 1)
+	TEXT=$(($1 - TEXT0)) DATA=$(($2 - DATA0)) BSS=$(($3 - BSS0))
+	set -- $("$TMP/$NAME.sizeof")
+	printf "%-12s %8s %8s %8s %8s %10s %10s\n" "$NAME" "$TEXT" "$OBJECT" "$DATA" "$BSS" "$1" "$2"
+}
+
+report default
+report no_double  -DBME280_USE_DOUBLE=0
+report no_int64   -DBME280_USE_INT64=0
+report no_single  -DBME280_USE_SINGLE=0
+report deadband   -DBME280_USE_DEADBAND=1
+report sink       -DBME280_USE_SINK=1
+report lut        -DBME280_USE_LUT=1
+report budget     -DBME280_USE_BUDGET=1
+report int32_only -DBME280_USE_DOUBLE=0 -DBME280_USE_INT64=0 -DBME280_USE_SINGLE=0